@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GSL_ALIGNED_RETAINED_HPP
+#define GSL_ALIGNED_RETAINED_HPP
+
+#include "contract.hpp"
+#include "relocatable.hpp"
+#include "retained.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#if __has_include(<version>)
+#include <version>
+#endif
+
+// Whether `aligned_retained` checks the alignment of the objects it references.
+#if !defined(GSL_POINTERS_ALIGNMENT_CHECKS)
+#if defined(NDEBUG)
+#define GSL_POINTERS_ALIGNMENT_CHECKS 0
+#else
+#define GSL_POINTERS_ALIGNMENT_CHECKS 1
+#endif
+#endif
+
+namespace gsl
+{
+  namespace detail
+  {
+    template <std::size_t N, typename T>
+    constexpr T* assume_aligned(T* p) noexcept
+    {
+#if defined(__cpp_lib_assume_aligned)
+      return std::assume_aligned<N>(p);
+#elif defined(__GNUC__) || defined(__clang__)
+      return static_cast<T*>(__builtin_assume_aligned(p, N));
+#else
+      return p;
+#endif
+    }
+  } // namespace detail
+
+  // A `retained<T>` to an object aligned to at least `N` bytes, which it
+  // communicates to the compiler on access so that aligned loads and stores can
+  // be used. The alignment is checked on construction unless `NDEBUG` is
+  // defined, or if `GSL_POINTERS_ALIGNMENT_CHECKS` is defined to 1, and a
+  // misaligned object is reported as a contract violation. As with `assert`,
+  // only the checking changes with the setting: the constructors are never
+  // `noexcept`, so that a violation handler can throw.
+  template <typename T, std::size_t N>
+  class GSL_TRIVIALLY_RELOCATABLE aligned_retained
+  {
+    static_assert((N & (N - 1)) == 0, "alignment must be a power of two");
+    static_assert(N >= alignof(T), "alignment must be at least that of `T`");
+
+    template <typename, std::size_t>
+    friend class aligned_retained;
+
+  public:
+    using element_type = T;
+
+    static constexpr std::size_t alignment = N;
+
+    explicit aligned_retained(T& t)
+    : m_ptr(std::addressof(t))
+    {
+      check_alignment();
+    }
+
+    explicit aligned_retained(T&&) noexcept = delete;
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    explicit aligned_retained(retained<U>&& r)
+    : m_ptr(&*r)
+    {
+      check_alignment();
+    }
+
+    template <
+        typename U,
+        std::size_t M,
+        typename = std::enable_if_t<std::is_convertible_v<U*, T*> && (M >= N)>>
+    constexpr aligned_retained(aligned_retained<U, M>&& other) noexcept
+    : m_ptr(other.m_ptr)
+    {
+    }
+
+    constexpr aligned_retained(aligned_retained const&) noexcept = delete;
+    constexpr aligned_retained(aligned_retained&&) noexcept = default;
+
+    constexpr aligned_retained& operator=(aligned_retained const&) noexcept = delete;
+    constexpr aligned_retained& operator=(aligned_retained&&) noexcept = default;
+
+    constexpr T* get() noexcept
+    {
+      return detail::assume_aligned<N>(m_ptr);
+    }
+
+    constexpr T const* get() const noexcept
+    {
+      return detail::assume_aligned<N>(static_cast<T const*>(m_ptr));
+    }
+
+    constexpr T& operator*() noexcept
+    {
+      return *get();
+    }
+
+    constexpr T const& operator*() const noexcept
+    {
+      return *get();
+    }
+
+    constexpr T* operator->() noexcept
+    {
+      return get();
+    }
+
+    constexpr T const* operator->() const noexcept
+    {
+      return get();
+    }
+
+    constexpr operator T const*() const noexcept
+    {
+      return get();
+    }
+
+    void swap(aligned_retained& other) noexcept
+    {
+      using std::swap;
+      swap(m_ptr, other.m_ptr);
+    }
+
+  private:
+    void check_alignment() const
+    {
+      if constexpr (GSL_POINTERS_ALIGNMENT_CHECKS)
+      {
+        detail::check(
+            reinterpret_cast<std::uintptr_t>(m_ptr) % N == 0,
+            "object is not sufficiently aligned");
+      }
+    }
+
+    T* m_ptr;
+  };
+
+  template <typename T, std::size_t N>
+  struct is_trivially_relocatable<aligned_retained<T, N>> : std::true_type
+  {
+  };
+
+  template <std::size_t N, typename T>
+  aligned_retained<T, N> make_retained_aligned(T& t)
+  {
+    return aligned_retained<T, N>(t);
+  }
+
+  template <std::size_t N, typename T>
+  aligned_retained<T, N> make_retained_aligned(T&&) = delete;
+
+  template <typename T, std::size_t N>
+  void swap(aligned_retained<T, N>& lhs, aligned_retained<T, N>& rhs) noexcept
+  {
+    lhs.swap(rhs);
+  }
+
+  template <typename T1, std::size_t N1, typename T2, std::size_t N2>
+  constexpr bool operator==(
+      aligned_retained<T1, N1> const& lhs, aligned_retained<T2, N2> const& rhs) noexcept
+  {
+    return &*lhs == &*rhs;
+  }
+
+  template <typename T1, std::size_t N1, typename T2, std::size_t N2>
+  constexpr bool operator!=(
+      aligned_retained<T1, N1> const& lhs, aligned_retained<T2, N2> const& rhs) noexcept
+  {
+    return !(lhs == rhs);
+  }
+} // namespace gsl
+
+#endif // GSL_ALIGNED_RETAINED_HPP
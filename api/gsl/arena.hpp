@@ -0,0 +1,309 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GSL_ARENA_HPP
+#define GSL_ARENA_HPP
+
+#include "retained.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Whether memory is poisoned when an arena is reset or released, so that
+// accesses through dangling references are more likely to be noticed.
+#if !defined(GSL_POINTERS_ARENA_POISON)
+#if defined(NDEBUG)
+#define GSL_POINTERS_ARENA_POISON 0
+#else
+#define GSL_POINTERS_ARENA_POISON 1
+#endif
+#endif
+
+#if defined(__SANITIZE_ADDRESS__)
+#define GSL_POINTERS_ASAN 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define GSL_POINTERS_ASAN 1
+#endif
+#endif
+
+#if defined(GSL_POINTERS_ASAN)
+#include <sanitizer/asan_interface.h>
+#endif
+
+namespace gsl
+{
+  // A monotonic memory resource that allocates from a list of blocks obtained
+  // from an upstream resource and frees them all at once. Objects created with
+  // `make` are destroyed, in reverse order of creation, when the arena is reset,
+  // released or destroyed.
+  class arena : public std::pmr::memory_resource
+  {
+  public:
+    // The byte pattern written over poisoned memory.
+    static constexpr unsigned char poison_byte = 0xdb;
+
+    explicit arena(
+        std::size_t initial_block_size = 4096,
+        std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept
+    : m_upstream(upstream)
+    , m_next_block_size(std::max(initial_block_size, sizeof(block)))
+    {
+    }
+
+    arena(arena const&) = delete;
+    arena& operator=(arena const&) = delete;
+
+    ~arena() override
+    {
+      release();
+    }
+
+    // Creates a `T` from `args` in the arena and returns a reference to it.
+    template <typename T, typename... Args>
+    retained<T> make(Args&&... args)
+    {
+      void* const storage = allocate(sizeof(T), alignof(T));
+
+      if constexpr (std::is_trivially_destructible_v<T>)
+      {
+        return retained<T>(*::new (storage) T(std::forward<Args>(args)...));
+      }
+      else
+      {
+        // The destructor record is allocated first so that nothing can fail
+        // after the object is constructed.
+        void* const record = allocate(sizeof(destructor), alignof(destructor));
+        T* const t = ::new (storage) T(std::forward<Args>(args)...);
+        m_destructors = ::new (record) destructor{&destroy<T>, t, m_destructors};
+        return retained<T>(*t);
+      }
+    }
+
+    // Destroys the objects created with `make` and makes all of the memory
+    // available for reuse, without returning it to the upstream resource.
+    void reset() noexcept
+    {
+      destroy_all();
+
+      for (block* b = m_head; b != nullptr; b = b->next)
+      {
+        poison(b->data(), b->capacity());
+      }
+
+      m_current = m_head;
+      rewind();
+    }
+
+    // Destroys the objects created with `make` and returns all of the memory to
+    // the upstream resource.
+    void release() noexcept
+    {
+      destroy_all();
+
+      while (m_head != nullptr)
+      {
+        block* const next = m_head->next;
+        std::size_t const size = m_head->size;
+        poison(m_head->data(), m_head->capacity());
+        unpoison(m_head->data(), m_head->capacity());
+        m_upstream->deallocate(m_head, size, alignof(block));
+        m_head = next;
+      }
+
+      m_current = nullptr;
+      m_ptr = nullptr;
+      m_end = nullptr;
+    }
+
+    std::pmr::memory_resource* upstream_resource() const noexcept
+    {
+      return m_upstream;
+    }
+
+  protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+      if (void* const p = try_bump(bytes, alignment))
+      {
+        return p;
+      }
+
+      // Move on to the next block, reusing any left from before a reset.
+      while (m_current != nullptr && m_current->next != nullptr)
+      {
+        m_current = m_current->next;
+        rewind();
+
+        if (void* const p = try_bump(bytes, alignment))
+        {
+          return p;
+        }
+      }
+
+      add_block(bytes + alignment);
+      return try_bump(bytes, alignment);
+    }
+
+    void do_deallocate(void*, std::size_t, std::size_t) noexcept override
+    {
+    }
+
+    bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override
+    {
+      return this == &other;
+    }
+
+  private:
+    struct alignas(std::max_align_t) block
+    {
+      block* next;
+      std::size_t size;
+
+      unsigned char* data() noexcept
+      {
+        return reinterpret_cast<unsigned char*>(this + 1);
+      }
+
+      std::size_t capacity() const noexcept
+      {
+        return size - sizeof(block);
+      }
+    };
+
+    struct destructor
+    {
+      void (*destroy)(void*) noexcept;
+      void* object;
+      destructor* next;
+    };
+
+    template <typename T>
+    static void destroy(void* p) noexcept
+    {
+      std::destroy_at(static_cast<T*>(p));
+    }
+
+    void* try_bump(std::size_t bytes, std::size_t alignment) noexcept
+    {
+      if (m_ptr == nullptr)
+      {
+        return nullptr;
+      }
+
+      auto const address = reinterpret_cast<std::uintptr_t>(m_ptr);
+      auto const padding = (alignment - address % alignment) % alignment;
+
+      if (padding > static_cast<std::size_t>(m_end - m_ptr)
+          || bytes > static_cast<std::size_t>(m_end - m_ptr) - padding)
+      {
+        return nullptr;
+      }
+
+      unsigned char* const p = m_ptr + padding;
+      m_ptr = p + bytes;
+      unpoison(p, bytes);
+      return p;
+    }
+
+    void add_block(std::size_t min_capacity)
+    {
+      std::size_t const size = std::max(m_next_block_size, min_capacity + sizeof(block));
+      void* const storage = m_upstream->allocate(size, alignof(block));
+      auto* const b = ::new (storage) block{nullptr, size};
+
+      if (m_current != nullptr)
+      {
+        // Any blocks after the current one have already been tried.
+        b->next = m_current->next;
+        m_current->next = b;
+      }
+      else
+      {
+        b->next = m_head;
+        m_head = b;
+      }
+
+      m_current = b;
+      m_next_block_size = size * 2;
+      poison(b->data(), b->capacity());
+      rewind();
+    }
+
+    void rewind() noexcept
+    {
+      m_ptr = m_current != nullptr ? m_current->data() : nullptr;
+      m_end = m_current != nullptr ? m_current->data() + m_current->capacity() : nullptr;
+    }
+
+    void destroy_all() noexcept
+    {
+      while (m_destructors != nullptr)
+      {
+        destructor* const d = m_destructors;
+        m_destructors = d->next;
+        d->destroy(d->object);
+      }
+    }
+
+    static void poison(void* p, std::size_t n) noexcept
+    {
+#if GSL_POINTERS_ARENA_POISON
+      unpoison(p, n);
+      std::memset(p, poison_byte, n);
+#if defined(GSL_POINTERS_ASAN)
+      ASAN_POISON_MEMORY_REGION(p, n);
+#endif
+#else
+      static_cast<void>(p);
+      static_cast<void>(n);
+#endif
+    }
+
+    static void unpoison(void* p, std::size_t n) noexcept
+    {
+#if GSL_POINTERS_ARENA_POISON && defined(GSL_POINTERS_ASAN)
+      ASAN_UNPOISON_MEMORY_REGION(p, n);
+#else
+      static_cast<void>(p);
+      static_cast<void>(n);
+#endif
+    }
+
+    std::pmr::memory_resource* m_upstream;
+    std::size_t m_next_block_size;
+    block* m_head = nullptr;
+    block* m_current = nullptr;
+    unsigned char* m_ptr = nullptr;
+    unsigned char* m_end = nullptr;
+    destructor* m_destructors = nullptr;
+  };
+} // namespace gsl
+
+#endif // GSL_ARENA_HPP
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GSL_ATOMIC_RETAINED_HPP
+#define GSL_ATOMIC_RETAINED_HPP
+
+#include "retained.hpp"
+
+#include <atomic>
+#include <memory>
+#include <type_traits>
+
+namespace gsl
+{
+  // An atomic `retained<T>`. Like `retained<T>`, it can only be constructed and
+  // assigned from `retained<T>`, so it can never be null nor bound to a
+  // temporary, and it only gives read-only access to the referenced object
+  // when it is itself read-only.
+  template <typename T>
+  class atomic_retained
+  {
+    static_assert(
+        std::atomic<T*>::is_always_lock_free,
+        "`atomic_retained<T>` requires lock-free atomic pointers");
+
+  public:
+    using value_type = retained<T>;
+
+    static constexpr bool is_always_lock_free = true;
+
+    explicit atomic_retained(retained<T> desired) noexcept
+    : m_ptr(std::addressof(*desired))
+    {
+    }
+
+    atomic_retained(atomic_retained const&) = delete;
+    atomic_retained& operator=(atomic_retained const&) = delete;
+
+    bool is_lock_free() const noexcept
+    {
+      return true;
+    }
+
+    void store(
+        retained<T> desired,
+        std::memory_order order = std::memory_order_seq_cst) noexcept
+    {
+      m_ptr.store(std::addressof(*desired), order);
+    }
+
+    retained<T> load(std::memory_order order = std::memory_order_seq_cst) noexcept
+    {
+      return retained<T>(*m_ptr.load(order));
+    }
+
+    retained<T const>
+    load(std::memory_order order = std::memory_order_seq_cst) const noexcept
+    {
+      return retained<T const>(*m_ptr.load(order));
+    }
+
+    retained<T> exchange(
+        retained<T> desired,
+        std::memory_order order = std::memory_order_seq_cst) noexcept
+    {
+      return retained<T>(*m_ptr.exchange(std::addressof(*desired), order));
+    }
+
+    bool compare_exchange_weak(
+        retained<T>& expected,
+        retained<T> desired,
+        std::memory_order success,
+        std::memory_order failure) noexcept
+    {
+      T* e = std::addressof(*expected);
+      bool const exchanged =
+          m_ptr.compare_exchange_weak(e, std::addressof(*desired), success, failure);
+
+      if (!exchanged)
+      {
+        expected = retained<T>(*e);
+      }
+
+      return exchanged;
+    }
+
+    bool compare_exchange_weak(
+        retained<T>& expected,
+        retained<T> desired,
+        std::memory_order order = std::memory_order_seq_cst) noexcept
+    {
+      T* e = std::addressof(*expected);
+      bool const exchanged =
+          m_ptr.compare_exchange_weak(e, std::addressof(*desired), order);
+
+      if (!exchanged)
+      {
+        expected = retained<T>(*e);
+      }
+
+      return exchanged;
+    }
+
+    bool compare_exchange_strong(
+        retained<T>& expected,
+        retained<T> desired,
+        std::memory_order success,
+        std::memory_order failure) noexcept
+    {
+      T* e = std::addressof(*expected);
+      bool const exchanged =
+          m_ptr.compare_exchange_strong(e, std::addressof(*desired), success, failure);
+
+      if (!exchanged)
+      {
+        expected = retained<T>(*e);
+      }
+
+      return exchanged;
+    }
+
+    bool compare_exchange_strong(
+        retained<T>& expected,
+        retained<T> desired,
+        std::memory_order order = std::memory_order_seq_cst) noexcept
+    {
+      T* e = std::addressof(*expected);
+      bool const exchanged =
+          m_ptr.compare_exchange_strong(e, std::addressof(*desired), order);
+
+      if (!exchanged)
+      {
+        expected = retained<T>(*e);
+      }
+
+      return exchanged;
+    }
+
+  private:
+    std::atomic<T*> m_ptr;
+  };
+
+} // namespace gsl
+
+#endif // GSL_ATOMIC_RETAINED_HPP
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GSL_CONTRACT_HPP
+#define GSL_CONTRACT_HPP
+
+#include <exception>
+
+// Selects what happens when a precondition, such as an optional being engaged
+// when its value is accessed, is violated:
+//
+// * `GSL_POINTERS_CONTRACT_THROW`: throw an exception (the default when
+//   exceptions are enabled)
+// * `GSL_POINTERS_CONTRACT_TERMINATE`: call `std::terminate` (the default when
+//   exceptions are disabled)
+// * `GSL_POINTERS_CONTRACT_HANDLER`: call the handler installed with
+//   `set_contract_violation_handler`, then `std::terminate` if it returns
+// * `GSL_POINTERS_CONTRACT_ASSUME`: assume that the precondition holds
+//
+// Defining `GSL_POINTERS_HARDENED` additionally checks that optionals are
+// engaged when they are dereferenced. Such violations are not reported by
+// throwing `std::bad_optional_access`.
+#define GSL_POINTERS_CONTRACT_THROW 0
+#define GSL_POINTERS_CONTRACT_TERMINATE 1
+#define GSL_POINTERS_CONTRACT_HANDLER 2
+#define GSL_POINTERS_CONTRACT_ASSUME 3
+
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define GSL_POINTERS_EXCEPTIONS 1
+#endif
+
+#if !defined(GSL_POINTERS_CONTRACT_MODE)
+#if defined(GSL_POINTERS_EXCEPTIONS)
+#define GSL_POINTERS_CONTRACT_MODE GSL_POINTERS_CONTRACT_THROW
+#else
+#define GSL_POINTERS_CONTRACT_MODE GSL_POINTERS_CONTRACT_TERMINATE
+#endif
+#endif
+
+#if GSL_POINTERS_CONTRACT_MODE == GSL_POINTERS_CONTRACT_THROW \
+    && !defined(GSL_POINTERS_EXCEPTIONS)
+#error "GSL_POINTERS_CONTRACT_THROW requires exceptions"
+#endif
+
+// The handler registration needs `<atomic>`, and the exceptions need
+// `<optional>`, so they are only included in the modes that use them.
+#if GSL_POINTERS_CONTRACT_MODE == GSL_POINTERS_CONTRACT_HANDLER
+#include "contract_handler.hpp"
+#elif GSL_POINTERS_CONTRACT_MODE == GSL_POINTERS_CONTRACT_THROW
+#include <optional>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define GSL_POINTERS_COLD __attribute__((cold, noinline))
+#define GSL_POINTERS_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#define GSL_POINTERS_UNREACHABLE() __builtin_unreachable()
+#elif defined(_MSC_VER)
+#define GSL_POINTERS_COLD __declspec(noinline)
+#define GSL_POINTERS_UNLIKELY(x) (x)
+#define GSL_POINTERS_UNREACHABLE() __assume(0)
+#else
+#define GSL_POINTERS_COLD
+#define GSL_POINTERS_UNLIKELY(x) (x)
+#define GSL_POINTERS_UNREACHABLE() std::terminate()
+#endif
+
+namespace gsl
+{
+  namespace detail
+  {
+    // The failure paths are kept out of line so that a check costs no more than
+    // a compare and branch at the call site.
+    [[noreturn]] GSL_POINTERS_COLD inline void contract_violation(char const* message)
+    {
+#if GSL_POINTERS_CONTRACT_MODE == GSL_POINTERS_CONTRACT_HANDLER
+      if (auto const handler = get_contract_violation_handler())
+      {
+        handler(message);
+      }
+#else
+      static_cast<void>(message);
+#endif
+
+      std::terminate();
+    }
+
+    [[noreturn]] GSL_POINTERS_COLD inline void bad_optional_access()
+    {
+#if GSL_POINTERS_CONTRACT_MODE == GSL_POINTERS_CONTRACT_THROW
+      throw std::bad_optional_access();
+#else
+      contract_violation("bad optional access");
+#endif
+    }
+
+    // Checks that an optional is engaged before its value is accessed.
+    constexpr void expect_engaged(bool engaged)
+    {
+#if GSL_POINTERS_CONTRACT_MODE == GSL_POINTERS_CONTRACT_ASSUME
+      if (!engaged)
+      {
+        GSL_POINTERS_UNREACHABLE();
+      }
+#else
+      if (GSL_POINTERS_UNLIKELY(!engaged))
+      {
+        bad_optional_access();
+      }
+#endif
+    }
+
+    // Checks that an optional is engaged before it is dereferenced, in hardened
+    // builds only.
+    constexpr void expect_dereferenceable(bool engaged)
+    {
+#if defined(GSL_POINTERS_HARDENED)
+#if GSL_POINTERS_CONTRACT_MODE == GSL_POINTERS_CONTRACT_ASSUME
+      if (!engaged)
+      {
+        GSL_POINTERS_UNREACHABLE();
+      }
+#else
+      if (GSL_POINTERS_UNLIKELY(!engaged))
+      {
+        contract_violation("dereference of a disengaged optional");
+      }
+#endif
+#else
+      static_cast<void>(engaged);
+#endif
+    }
+
+    // Checks a precondition that is too expensive or too rarely violated to
+    // check by default, in hardened builds only.
+    constexpr void expect(bool condition, char const* message)
+    {
+#if defined(GSL_POINTERS_HARDENED)
+#if GSL_POINTERS_CONTRACT_MODE == GSL_POINTERS_CONTRACT_ASSUME
+      static_cast<void>(message);
+
+      if (!condition)
+      {
+        GSL_POINTERS_UNREACHABLE();
+      }
+#else
+      if (GSL_POINTERS_UNLIKELY(!condition))
+      {
+        contract_violation(message);
+      }
+#endif
+#else
+      static_cast<void>(condition);
+      static_cast<void>(message);
+#endif
+    }
+
+    // Checks a precondition that cannot be verified by the caller, such as an
+    // object being within range of an offset, in all builds.
+    constexpr void check(bool condition, char const* message)
+    {
+#if GSL_POINTERS_CONTRACT_MODE == GSL_POINTERS_CONTRACT_ASSUME
+      static_cast<void>(message);
+
+      if (!condition)
+      {
+        GSL_POINTERS_UNREACHABLE();
+      }
+#else
+      if (GSL_POINTERS_UNLIKELY(!condition))
+      {
+        contract_violation(message);
+      }
+#endif
+    }
+
+    // Checks that an index or subrange lies within a sequence, in hardened builds
+    // only.
+    constexpr void expect_in_bounds(bool in_bounds)
+    {
+#if defined(GSL_POINTERS_HARDENED)
+#if GSL_POINTERS_CONTRACT_MODE == GSL_POINTERS_CONTRACT_ASSUME
+      if (!in_bounds)
+      {
+        GSL_POINTERS_UNREACHABLE();
+      }
+#else
+      if (GSL_POINTERS_UNLIKELY(!in_bounds))
+      {
+        contract_violation("access out of bounds");
+      }
+#endif
+#else
+      static_cast<void>(in_bounds);
+#endif
+    }
+  } // namespace detail
+} // namespace gsl
+
+#endif // GSL_CONTRACT_HPP
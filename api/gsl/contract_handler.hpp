@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GSL_CONTRACT_HANDLER_HPP
+#define GSL_CONTRACT_HANDLER_HPP
+
+#include <atomic>
+
+// The handler called by contract violations in `GSL_POINTERS_CONTRACT_HANDLER`
+// mode. It can be installed in any mode, but is only called in that one.
+namespace gsl
+{
+  // Called with a description of the violated precondition. It may throw, but
+  // must not return.
+  using contract_violation_handler = void (*)(char const* message);
+
+  namespace detail
+  {
+    inline std::atomic<contract_violation_handler>& contract_handler() noexcept
+    {
+      static std::atomic<contract_violation_handler> handler = {nullptr};
+      return handler;
+    }
+  } // namespace detail
+
+  // Installs the handler used in `GSL_POINTERS_CONTRACT_HANDLER` mode and
+  // returns the previous one.
+  inline contract_violation_handler set_contract_violation_handler(
+      contract_violation_handler handler) noexcept
+  {
+    return detail::contract_handler().exchange(handler);
+  }
+
+  inline contract_violation_handler get_contract_violation_handler() noexcept
+  {
+    return detail::contract_handler().load();
+  }
+} // namespace gsl
+
+#endif // GSL_CONTRACT_HANDLER_HPP
@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GSL_DEREF_VIEW_HPP
+#define GSL_DEREF_VIEW_HPP
+
+#include "optional_ref.hpp"
+#include "retained.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <xmmintrin.h>
+#endif
+
+namespace gsl
+{
+  // The number of elements ahead of the current position to prefetch when
+  // iterating over references to objects of type `T` with `deref`.
+  // Specialize this to tune prefetching per type; the default of zero
+  // disables it.
+  template <typename T>
+  struct prefetch_distance : std::integral_constant<std::size_t, 0>
+  {
+  };
+
+  template <typename T>
+  inline constexpr std::size_t prefetch_distance_v = prefetch_distance<T>::value;
+
+  namespace detail
+  {
+    template <typename T>
+    constexpr T* element_address(retained<T>& r) noexcept
+    {
+      return &*r;
+    }
+
+    template <typename T>
+    constexpr T const* element_address(retained<T> const& r) noexcept
+    {
+      return &*r;
+    }
+
+    template <typename T>
+    constexpr T* element_address(optional_ref<T> const& o) noexcept
+    {
+      return o ? &*o : nullptr;
+    }
+
+    template <typename T>
+    constexpr T* element_address(T* p) noexcept
+    {
+      return p;
+    }
+
+    template <typename T>
+    struct is_nullable_reference : std::false_type
+    {
+    };
+
+    template <typename T>
+    struct is_nullable_reference<optional_ref<T>> : std::true_type
+    {
+    };
+
+    template <typename T>
+    struct is_nullable_reference<T*> : std::true_type
+    {
+    };
+
+    inline void prefetch(void const* p) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+      __builtin_prefetch(p);
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+      _mm_prefetch(static_cast<char const*>(p), _MM_HINT_T0);
+#else
+      static_cast<void>(p);
+#endif
+    }
+
+    // Holds the end of the underlying range only for iterators that need it.
+    template <typename It, bool>
+    struct deref_iterator_end
+    {
+      constexpr explicit deref_iterator_end(It const&) noexcept
+      {
+      }
+    };
+
+    template <typename It>
+    struct deref_iterator_end<It, true>
+    {
+      constexpr explicit deref_iterator_end(It const& end)
+      : m_end(end)
+      {
+      }
+
+      It m_end;
+    };
+  } // namespace detail
+
+  // A view of a range of `retained<T>`, `optional_ref<T>` or `T*` that yields
+  // `T&`, skipping disengaged `optional_ref`s and null pointers. If `Distance`
+  // is non-zero, the object referenced `Distance` elements ahead of the
+  // current position is prefetched on each increment, hiding the latency of
+  // the dependent load. With a `Distance` of zero over a range of
+  // `retained<T>`, the iterator is no larger than the underlying iterator and
+  // does nothing more than dereference it.
+  template <typename Range, std::size_t Distance>
+  class deref_view
+  {
+    using base_iterator = decltype(std::begin(std::declval<Range&>()));
+    using base_reference = decltype(*std::declval<base_iterator const&>());
+    using base_value = std::remove_cv_t<std::remove_reference_t<base_reference>>;
+    using pointer = decltype(detail::element_address(std::declval<base_reference>()));
+
+    static constexpr bool nullable = detail::is_nullable_reference<base_value>::value;
+    static constexpr bool needs_end = nullable || Distance > 0;
+
+    static_assert(
+        Distance == 0
+            || std::is_base_of_v<
+                std::random_access_iterator_tag,
+                typename std::iterator_traits<base_iterator>::iterator_category>,
+        "prefetching requires a random access range");
+
+  public:
+    using element_type = std::remove_pointer_t<pointer>;
+
+    class iterator : detail::deref_iterator_end<base_iterator, needs_end>
+    {
+      using end_base = detail::deref_iterator_end<base_iterator, needs_end>;
+
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = std::remove_cv_t<element_type>;
+      using difference_type = std::ptrdiff_t;
+      using pointer = element_type*;
+      using reference = element_type&;
+
+      iterator(base_iterator it, base_iterator end)
+      : end_base(end)
+      , m_it(std::move(it))
+      {
+        skip_disengaged();
+
+        if constexpr (Distance > 0)
+        {
+          for (std::size_t n = 0; n < Distance && n < remaining(); ++n)
+          {
+            detail::prefetch(
+                detail::element_address(m_it[static_cast<difference_type>(n)]));
+          }
+        }
+      }
+
+      element_type& operator*() const noexcept
+      {
+        return *detail::element_address(*m_it);
+      }
+
+      element_type* operator->() const noexcept
+      {
+        return detail::element_address(*m_it);
+      }
+
+      iterator& operator++()
+      {
+        ++m_it;
+
+        if constexpr (Distance > 0)
+        {
+          if (remaining() > Distance)
+          {
+            detail::prefetch(
+                detail::element_address(m_it[static_cast<difference_type>(Distance)]));
+          }
+        }
+
+        skip_disengaged();
+        return *this;
+      }
+
+      iterator operator++(int)
+      {
+        iterator it = *this;
+        ++*this;
+        return it;
+      }
+
+      friend bool operator==(iterator const& lhs, iterator const& rhs)
+      {
+        return lhs.m_it == rhs.m_it;
+      }
+
+      friend bool operator!=(iterator const& lhs, iterator const& rhs)
+      {
+        return lhs.m_it != rhs.m_it;
+      }
+
+    private:
+      std::size_t remaining() const
+      {
+        return static_cast<std::size_t>(end_base::m_end - m_it);
+      }
+
+      void skip_disengaged()
+      {
+        if constexpr (nullable)
+        {
+          while (m_it != end_base::m_end && detail::element_address(*m_it) == nullptr)
+          {
+            ++m_it;
+          }
+        }
+      }
+
+      base_iterator m_it;
+    };
+
+    constexpr explicit deref_view(Range& range) noexcept
+    : m_range(range)
+    {
+    }
+
+    iterator begin() const
+    {
+      return iterator(std::begin(m_range), std::end(m_range));
+    }
+
+    iterator end() const
+    {
+      return iterator(std::end(m_range), std::end(m_range));
+    }
+
+  private:
+    Range& m_range;
+  };
+
+  // Returns a view of `range` that yields the referenced objects, prefetching
+  // as configured by `prefetch_distance`.
+  template <typename Range>
+  auto deref(Range& range) noexcept
+  {
+    using element = std::remove_cv_t<typename deref_view<Range, 0>::element_type>;
+    return deref_view<Range, prefetch_distance_v<element>>(range);
+  }
+
+  template <typename Range>
+  auto deref(Range const&&) = delete;
+
+  // Returns a view of `range` that yields the referenced objects, prefetching
+  // `Distance` elements ahead.
+  template <std::size_t Distance, typename Range>
+  deref_view<Range, Distance> prefetching(Range& range) noexcept
+  {
+    return deref_view<Range, Distance>(range);
+  }
+
+  template <std::size_t Distance, typename Range>
+  deref_view<Range, Distance> prefetching(Range const&&) = delete;
+
+} // namespace gsl
+
+#endif // GSL_DEREF_VIEW_HPP
@@ -0,0 +1,427 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GSL_EPOCH_HPP
+#define GSL_EPOCH_HPP
+
+#include "atomic_retained.hpp"
+#include "contract.hpp"
+#include "retained.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gsl
+{
+  class epoch_guard;
+
+  // An epoch-based reclamation domain. Reader threads register themselves as
+  // participants and pin the current epoch for the duration of each read-side
+  // critical section. Objects retired by writers are reclaimed only once every
+  // pinned participant has moved on to a later epoch, by which time no reader
+  // can still hold a reference to them.
+  //
+  // Pinning and unpinning write only to a cache line owned by the calling
+  // thread; only writers contend on shared state.
+  class epoch_domain
+  {
+    friend class epoch_guard;
+
+    struct alignas(64) record
+    {
+      // The epoch pinned by the participant, or zero if not pinned.
+      std::atomic<std::uint64_t> epoch = {0};
+      std::atomic<bool> in_use = {true};
+      std::size_t nesting = 0;
+      record* next = nullptr;
+    };
+
+    struct retired
+    {
+      void* ptr;
+      void (*reclaim)(void*);
+      std::uint64_t epoch;
+    };
+
+  public:
+    // A base class that lets an object be retired with `retire_lock_free`,
+    // which links the object into the domain instead of allocating a record.
+    class retire_hook
+    {
+      friend class epoch_domain;
+
+      retire_hook* m_next = nullptr;
+      void (*m_reclaim)(retire_hook&) = nullptr;
+      std::uint64_t m_epoch = 0;
+    };
+
+    // A registration of a thread with an `epoch_domain`. Each thread that
+    // reads objects protected by the domain must own a `participant`, which
+    // must not be shared with other threads.
+    class participant
+    {
+    public:
+      explicit participant(epoch_domain& domain)
+      : m_domain(domain)
+      , m_record(domain.acquire_record())
+      {
+      }
+
+      participant(participant const&) = delete;
+      participant& operator=(participant const&) = delete;
+
+      ~participant()
+      {
+        m_record.epoch.store(0, std::memory_order_release);
+        m_record.in_use.store(false, std::memory_order_release);
+      }
+
+      epoch_guard pin() noexcept;
+
+    private:
+      epoch_domain& m_domain;
+      record& m_record;
+    };
+
+    epoch_domain() = default;
+
+    epoch_domain(epoch_domain const&) = delete;
+    epoch_domain& operator=(epoch_domain const&) = delete;
+
+    // All participants must have been destroyed before the domain is.
+    ~epoch_domain()
+    {
+      for (auto& r : m_retired)
+      {
+        r.reclaim(r.ptr);
+      }
+
+      reclaim_hooks(m_hooks.exchange(nullptr, std::memory_order_acquire));
+      reclaim_hooks(m_adopted_hooks);
+
+      for (record* r = m_records.load(std::memory_order_acquire); r != nullptr;)
+      {
+        record* next = r->next;
+        delete r;
+        r = next;
+      }
+    }
+
+    // Schedules `p` to be destroyed with `Deleter` once no pinned participant
+    // can still be reading it. `p` must already be unreachable to readers that
+    // pin the domain after this call.
+    template <typename T, typename Deleter = std::default_delete<T>>
+    void retire(T* p)
+    {
+      std::lock_guard<std::mutex> lock(m_retired_mutex);
+
+      m_retired.push_back(retired{
+          const_cast<void*>(static_cast<void const volatile*>(p)),
+          [](void* ptr) { Deleter()(static_cast<T*>(ptr)); },
+          m_epoch.load(std::memory_order_seq_cst)});
+
+      if (m_retired.size() >= collect_threshold)
+      {
+        collect_locked();
+      }
+    }
+
+    // Schedules `p`, which must derive from `retire_hook`, to be destroyed with
+    // `Deleter` once no pinned participant can still be reading it. Unlike
+    // `retire`, this never allocates or waits for a lock: `p` is pushed onto a
+    // lock-free list, and reclaimed by a later `collect`, which is attempted
+    // here only if no other thread is collecting.
+    template <typename T, typename Deleter = std::default_delete<T>>
+    void retire_lock_free(T* p) noexcept
+    {
+      static_assert(
+          std::is_base_of_v<retire_hook, T>, "`T` must derive from `retire_hook`");
+
+      retire_hook& hook = *p;
+      hook.m_reclaim = [](retire_hook& h) { Deleter()(static_cast<T*>(&h)); };
+      hook.m_epoch = m_epoch.load(std::memory_order_seq_cst);
+      hook.m_next = m_hooks.load(std::memory_order_relaxed);
+
+      while (!m_hooks.compare_exchange_weak(
+          hook.m_next, &hook, std::memory_order_release, std::memory_order_relaxed))
+      {
+      }
+
+      if (m_hook_count.fetch_add(1, std::memory_order_relaxed) + 1 >= collect_threshold
+          && m_retired_mutex.try_lock())
+      {
+        std::lock_guard<std::mutex> lock(m_retired_mutex, std::adopt_lock);
+        collect_locked();
+      }
+    }
+
+    // Attempts to advance the epoch and reclaims every retired object that is
+    // no longer reachable by any reader. Returns the number of objects
+    // reclaimed.
+    std::size_t collect()
+    {
+      std::lock_guard<std::mutex> lock(m_retired_mutex);
+      return collect_locked();
+    }
+
+    std::uint64_t epoch() const noexcept
+    {
+      return m_epoch.load(std::memory_order_acquire);
+    }
+
+  private:
+    static constexpr std::size_t collect_threshold = 64;
+
+    record& acquire_record()
+    {
+      for (record* r = m_records.load(std::memory_order_acquire); r != nullptr;
+           r = r->next)
+      {
+        bool expected = false;
+
+        if (!r->in_use.load(std::memory_order_relaxed)
+            && r->in_use.compare_exchange_strong(expected, true))
+        {
+          return *r;
+        }
+      }
+
+      auto r = new record();
+      r->next = m_records.load(std::memory_order_relaxed);
+
+      while (!m_records.compare_exchange_weak(
+          r->next, r, std::memory_order_release, std::memory_order_relaxed))
+      {
+      }
+
+      return *r;
+    }
+
+    bool try_advance() noexcept
+    {
+      // Pairs with the fence in `epoch_guard`: either this scan sees the epoch
+      // pinned by a reader, or that reader sees every object unlinked before
+      // this call, which is what the two-epoch grace period relies on on
+      // hardware that reorders stores after loads.
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+
+      std::uint64_t const current = m_epoch.load(std::memory_order_seq_cst);
+
+      for (record* r = m_records.load(std::memory_order_acquire); r != nullptr;
+           r = r->next)
+      {
+        std::uint64_t const pinned = r->epoch.load(std::memory_order_seq_cst);
+
+        if (pinned != 0 && pinned != current)
+        {
+          return false;
+        }
+      }
+
+      std::uint64_t expected = current;
+      return m_epoch.compare_exchange_strong(expected, current + 1);
+    }
+
+    std::size_t collect_locked()
+    {
+      try_advance();
+
+      // Readers pinned at the retirement epoch may still hold a reference, and
+      // so may readers pinned at the following one, which began before the
+      // epoch was advanced past the retirement epoch.
+      std::uint64_t const current = m_epoch.load(std::memory_order_seq_cst);
+      std::size_t reclaimed = 0;
+
+      auto it = m_retired.begin();
+
+      while (it != m_retired.end())
+      {
+        if (it->epoch + 2 <= current)
+        {
+          it->reclaim(it->ptr);
+          *it = m_retired.back();
+          m_retired.pop_back();
+          ++reclaimed;
+        }
+        else
+        {
+          ++it;
+        }
+      }
+
+      // Objects retired with `retire_lock_free` are adopted into a list that is
+      // only accessed with the lock held.
+      for (retire_hook* h = m_hooks.exchange(nullptr, std::memory_order_acquire);
+           h != nullptr;)
+      {
+        retire_hook* next = h->m_next;
+        h->m_next = m_adopted_hooks;
+        m_adopted_hooks = h;
+        h = next;
+      }
+
+      for (retire_hook** link = &m_adopted_hooks; *link != nullptr;)
+      {
+        retire_hook& h = **link;
+
+        if (h.m_epoch + 2 <= current)
+        {
+          *link = h.m_next;
+          h.m_reclaim(h);
+          m_hook_count.fetch_sub(1, std::memory_order_relaxed);
+          ++reclaimed;
+        }
+        else
+        {
+          link = &h.m_next;
+        }
+      }
+
+      return reclaimed;
+    }
+
+    static void reclaim_hooks(retire_hook* h) noexcept
+    {
+      while (h != nullptr)
+      {
+        retire_hook* next = h->m_next;
+        h->m_reclaim(*h);
+        h = next;
+      }
+    }
+
+    alignas(64) std::atomic<std::uint64_t> m_epoch = {1};
+    std::atomic<record*> m_records = {nullptr};
+    alignas(64) std::atomic<retire_hook*> m_hooks = {nullptr};
+    std::atomic<std::size_t> m_hook_count = {0};
+    alignas(64) std::mutex m_retired_mutex;
+    std::vector<retired> m_retired;
+    retire_hook* m_adopted_hooks = nullptr;
+  };
+
+  // Pins the epoch of a domain for its lifetime. Guards can be nested.
+  class epoch_guard
+  {
+    friend class epoch_domain::participant;
+
+  public:
+    epoch_guard(epoch_guard const&) = delete;
+    epoch_guard& operator=(epoch_guard const&) = delete;
+
+    ~epoch_guard()
+    {
+      if (--m_record.nesting == 0)
+      {
+        m_record.epoch.store(0, std::memory_order_release);
+      }
+    }
+
+    epoch_domain& domain() const noexcept
+    {
+      return m_domain;
+    }
+
+  private:
+    epoch_guard(epoch_domain& domain, epoch_domain::record& record) noexcept
+    : m_domain(domain)
+    , m_record(record)
+    {
+      if (m_record.nesting++ == 0)
+      {
+        m_record.epoch.store(
+            m_domain.m_epoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+      }
+    }
+
+    epoch_domain& m_domain;
+    epoch_domain::record& m_record;
+  };
+
+  inline epoch_guard epoch_domain::participant::pin() noexcept
+  {
+    return epoch_guard(m_domain, m_record);
+  }
+
+  // A shared, atomically replaceable `retained<T>` whose referenced objects are
+  // reclaimed through an `epoch_domain`. Readers may only load it while holding
+  // an `epoch_guard`, and the loaded `retained<T>` must not outlive the guard.
+  template <typename T>
+  class guarded_retained
+  {
+  public:
+    guarded_retained(epoch_domain& domain, retained<T> desired) noexcept
+    : m_domain(domain)
+    , m_ref(std::move(desired))
+    {
+    }
+
+    guarded_retained(guarded_retained const&) = delete;
+    guarded_retained& operator=(guarded_retained const&) = delete;
+
+    retained<T> load(epoch_guard const& guard)
+    {
+      detail::expect(&guard.domain() == &m_domain, "guard pins a different epoch domain");
+      return m_ref.load(std::memory_order_acquire);
+    }
+
+    retained<T const> load(epoch_guard const& guard) const
+    {
+      detail::expect(&guard.domain() == &m_domain, "guard pins a different epoch domain");
+      return m_ref.load(std::memory_order_acquire);
+    }
+
+    // Publishes `desired` and returns the previously published object, which
+    // readers may still be using. The caller is responsible for retiring it.
+    retained<T> exchange(retained<T> desired) noexcept
+    {
+      return m_ref.exchange(std::move(desired), std::memory_order_acq_rel);
+    }
+
+    // Publishes `desired` and retires the previously published object, which
+    // is destroyed with `Deleter` once no reader can still be using it.
+    template <typename Deleter = std::default_delete<T>>
+    void replace(retained<T> desired)
+    {
+      retained<T> previous = exchange(std::move(desired));
+      m_domain.retire<T, Deleter>(std::addressof(*previous));
+    }
+
+    epoch_domain& domain() const noexcept
+    {
+      return m_domain;
+    }
+
+  private:
+    epoch_domain& m_domain;
+    atomic_retained<T> m_ref;
+  };
+
+} // namespace gsl
+
+#endif // GSL_EPOCH_HPP
@@ -0,0 +1,300 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GSL_GATHER_HPP
+#define GSL_GATHER_HPP
+
+#include "contract.hpp"
+#include "optional_ref.hpp"
+#include "retained.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+#if (defined(__x86_64__) || defined(_M_X64)) \
+    && (defined(__AVX2__) || defined(__AVX512F__))
+#define GSL_POINTERS_GATHER_X86 1
+#include <immintrin.h>
+#endif
+
+namespace gsl
+{
+  namespace detail
+  {
+    // The vector kernels apply the offset of the member in one object to all of
+    // them, which is only guaranteed to be valid for standard-layout types.
+    template <typename U, typename M>
+    constexpr bool is_vector_gatherable = std::is_standard_layout_v<U>
+        && std::is_trivially_copyable_v<M> && (sizeof(M) == 4 || sizeof(M) == 8)
+        && sizeof(void*) == 8;
+
+#if defined(GSL_POINTERS_GATHER_X86)
+    // Gathers `Size` bytes at `offset` from each of the `n` non-null pointers
+    // in `ptrs` into `out`, or copies `default_value` for null pointers if
+    // `Nullable`. Returns the number of leading elements processed; the
+    // remainder is left to the caller.
+    template <std::size_t Size, bool Nullable>
+    std::size_t gather_vector(
+        void const* ptrs,
+        std::size_t n,
+        std::ptrdiff_t offset,
+        void* out,
+        void const* default_value) noexcept
+    {
+      auto const in = static_cast<unsigned char const*>(ptrs);
+      auto const dst = static_cast<unsigned char*>(out);
+      std::size_t i = 0;
+
+#if defined(__AVX512F__)
+      __m512i const offsets = _mm512_set1_epi64(offset);
+
+      // The unmasked gathers leave their source operand uninitialized, which
+      // GCC warns about, so a full mask is used instead.
+      __mmask8 const all = 0xFF;
+
+      for (; i + 8 <= n; i += 8)
+      {
+        __m512i const p = _mm512_loadu_si512(in + i * 8);
+        __m512i const index = _mm512_add_epi64(p, offsets);
+
+        if constexpr (Size == 4)
+        {
+          __m256i v;
+
+          if constexpr (Nullable)
+          {
+            std::int32_t d;
+            std::memcpy(&d, default_value, 4);
+            __mmask8 const engaged = _mm512_test_epi64_mask(p, p);
+            v = _mm512_mask_i64gather_epi32(
+                _mm256_set1_epi32(d), engaged, index, nullptr, 1);
+          }
+          else
+          {
+            v = _mm512_mask_i64gather_epi32(
+                _mm256_setzero_si256(), all, index, nullptr, 1);
+          }
+
+          _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), v);
+        }
+        else
+        {
+          __m512i v;
+
+          if constexpr (Nullable)
+          {
+            long long d;
+            std::memcpy(&d, default_value, 8);
+            __mmask8 const engaged = _mm512_test_epi64_mask(p, p);
+            v = _mm512_mask_i64gather_epi64(
+                _mm512_set1_epi64(d), engaged, index, nullptr, 1);
+          }
+          else
+          {
+            v = _mm512_mask_i64gather_epi64(
+                _mm512_setzero_si512(), all, index, nullptr, 1);
+          }
+
+          _mm512_storeu_si512(dst + i * 8, v);
+        }
+      }
+#else
+      __m256i const offsets = _mm256_set1_epi64x(offset);
+
+      for (; i + 4 <= n; i += 4)
+      {
+        __m256i const p =
+            _mm256_loadu_si256(reinterpret_cast<__m256i const*>(in + i * 8));
+        __m256i const index = _mm256_add_epi64(p, offsets);
+
+        if constexpr (Size == 4)
+        {
+          __m128i v;
+
+          if constexpr (Nullable)
+          {
+            int d;
+            std::memcpy(&d, default_value, 4);
+            __m256i const engaged = _mm256_xor_si256(
+                _mm256_cmpeq_epi64(p, _mm256_setzero_si256()), _mm256_set1_epi64x(-1));
+            __m128i const mask = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(
+                engaged, _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6)));
+            v = _mm256_mask_i64gather_epi32(
+                _mm_set1_epi32(d), static_cast<int const*>(nullptr), index, mask, 1);
+          }
+          else
+          {
+            v = _mm256_i64gather_epi32(static_cast<int const*>(nullptr), index, 1);
+          }
+
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), v);
+        }
+        else
+        {
+          __m256i v;
+
+          if constexpr (Nullable)
+          {
+            long long d;
+            std::memcpy(&d, default_value, 8);
+            __m256i const engaged = _mm256_xor_si256(
+                _mm256_cmpeq_epi64(p, _mm256_setzero_si256()), _mm256_set1_epi64x(-1));
+            v = _mm256_mask_i64gather_epi64(
+                _mm256_set1_epi64x(d),
+                static_cast<long long const*>(nullptr),
+                index,
+                engaged,
+                1);
+          }
+          else
+          {
+            v = _mm256_i64gather_epi64(static_cast<long long const*>(nullptr), index, 1);
+          }
+
+          _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 8), v);
+        }
+      }
+#endif
+
+      return i;
+    }
+#endif
+
+    template <typename T, typename U>
+    std::ptrdiff_t member_offset(T const& object, U const& member) noexcept
+    {
+      return reinterpret_cast<unsigned char const*>(std::addressof(member))
+          - reinterpret_cast<unsigned char const*>(std::addressof(object));
+    }
+  } // namespace detail
+
+  // Copies `member` of each of the `n` objects referenced by `in` to `out`.
+  // Uses AVX2 or AVX-512 gather instructions where available, the referenced
+  // type is standard-layout and the member is four or eight bytes in size, and a
+  // scalar loop otherwise. Arm NEON has no gather instruction, so the scalar loop
+  // is used there.
+  template <typename T, typename U, typename M>
+  void gather(
+      retained<T> const* in,
+      std::size_t n,
+      M U::*member,
+      std::remove_cv_t<M>* out) noexcept
+  {
+    static_assert(
+        std::is_same_v<std::remove_cv_t<T>, U>,
+        "`member` must be a member of the referenced type");
+
+    std::size_t i = 0;
+
+#if defined(GSL_POINTERS_GATHER_X86)
+    if constexpr (detail::is_vector_gatherable<U, M>)
+    {
+      if (n != 0)
+      {
+        auto const offset = detail::member_offset(*in[0], (*in[0]).*member);
+        i = detail::gather_vector<sizeof(M), false>(
+            as_pointers(in), n, offset, out, nullptr);
+      }
+    }
+#endif
+
+    for (; i < n; ++i)
+    {
+      out[i] = (*in[i]).*member;
+    }
+  }
+
+  // Copies `member` of each of the `n` objects referenced by `in` to `out`,
+  // or `default_value` for each disengaged `optional_ref`.
+  template <typename T, typename U, typename M>
+  void gather(
+      optional_ref<T> const* in,
+      std::size_t n,
+      M U::*member,
+      std::remove_cv_t<M>* out,
+      std::remove_cv_t<M> const& default_value = {}) noexcept
+  {
+    static_assert(
+        std::is_same_v<std::remove_cv_t<T>, U>,
+        "`member` must be a member of the referenced type");
+
+    std::size_t i = 0;
+
+#if defined(GSL_POINTERS_GATHER_X86)
+    if constexpr (detail::is_vector_gatherable<U, M>)
+    {
+      // The offset of the member is found from the first engaged element.
+      std::size_t first = 0;
+
+      while (first < n && !in[first])
+      {
+        ++first;
+      }
+
+      if (first != n)
+      {
+        auto const offset = detail::member_offset(*in[first], (*in[first]).*member);
+        i = detail::gather_vector<sizeof(M), true>(
+            as_pointers(in), n, offset, out, &default_value);
+      }
+    }
+#endif
+
+    for (; i < n; ++i)
+    {
+      out[i] = in[i] ? (*in[i]).*member : default_value;
+    }
+  }
+
+  // Copies `member` of each object referenced by the contiguous range `in` to
+  // the contiguous range `out`, which must be at least as large as `in`. This is
+  // checked in hardened builds.
+  template <typename In, typename U, typename M, typename Out>
+  auto gather(In const& in, M U::*member, Out&& out)
+      -> decltype(gather(std::data(in), std::size(in), member, std::data(out)))
+  {
+    detail::expect_in_bounds(std::size(out) >= std::size(in));
+
+    gather(std::data(in), std::size(in), member, std::data(out));
+  }
+
+  template <typename In, typename U, typename M, typename Out>
+  auto gather(
+      In const& in,
+      M U::*member,
+      Out&& out,
+      std::remove_cv_t<M> const& default_value)
+      -> decltype(
+          gather(std::data(in), std::size(in), member, std::data(out), default_value))
+  {
+    detail::expect_in_bounds(std::size(out) >= std::size(in));
+
+    gather(std::data(in), std::size(in), member, std::data(out), default_value);
+  }
+
+} // namespace gsl
+
+#endif // GSL_GATHER_HPP
@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GSL_INSTRUMENT_HPP
+#define GSL_INSTRUMENT_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(GSL_POINTERS_INSTRUMENT)
+#include <atomic>
+#include <mutex>
+#endif
+
+// Defining `GSL_POINTERS_INSTRUMENT` counts how often the hot paths of
+// `retained` and `optional_ref` are reached, so that profiles can show where
+// code would benefit from switching to `retained` or to identity comparison.
+// Each thread counts into its own cache line, and the totals across threads are
+// collected with `drain_instrument_counters`. The counters are held outside the
+// instrumented objects, whose layout is the same in both modes.
+//
+// All translation units in a program must agree on whether the mode is
+// enabled.
+
+namespace gsl
+{
+  enum class instrument_counter : std::size_t
+  {
+    // `retained` or `optional_ref` dereferenced with `*` or `->`.
+    dereference,
+    // `optional_ref` tested with `has_value` or `operator bool`.
+    engagement_check,
+    // `value` called on a disengaged `optional_ref`.
+    value_failure,
+    // `value_or` copying a value out of an `optional_ref`.
+    value_or_copy,
+    // `optional_ref`s or values compared by the referenced values.
+    deep_comparison,
+  };
+
+  inline constexpr std::size_t instrument_counter_count = 5;
+
+  constexpr char const* instrument_counter_name(instrument_counter counter) noexcept
+  {
+    switch (counter)
+    {
+    case instrument_counter::dereference:
+      return "dereference";
+    case instrument_counter::engagement_check:
+      return "engagement_check";
+    case instrument_counter::value_failure:
+      return "value_failure";
+    case instrument_counter::value_or_copy:
+      return "value_or_copy";
+    case instrument_counter::deep_comparison:
+      return "deep_comparison";
+    }
+
+    return "";
+  }
+
+  struct instrument_counts
+  {
+    std::uint64_t values[instrument_counter_count] = {};
+
+    constexpr std::uint64_t operator[](instrument_counter counter) const noexcept
+    {
+      return values[static_cast<std::size_t>(counter)];
+    }
+  };
+
+#if defined(GSL_POINTERS_INSTRUMENT)
+  namespace detail
+  {
+    struct alignas(64) instrument_block
+    {
+      // Written only by the owning thread, so increments need not be atomic
+      // read-modify-write operations.
+      std::atomic<std::uint64_t> values[instrument_counter_count] = {};
+
+      // The values as of the last drain, guarded by the registry's mutex.
+      std::uint64_t drained[instrument_counter_count] = {};
+
+      instrument_block* prev = nullptr;
+      instrument_block* next = nullptr;
+    };
+
+    class instrument_registry
+    {
+    public:
+      void attach(instrument_block& block)
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        block.next = m_head;
+
+        if (m_head != nullptr)
+        {
+          m_head->prev = &block;
+        }
+
+        m_head = &block;
+      }
+
+      // Keeps the undrained counts of a thread that is exiting.
+      void detach(instrument_block& block)
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        collect(block, m_pending);
+
+        (block.prev != nullptr ? block.prev->next : m_head) = block.next;
+
+        if (block.next != nullptr)
+        {
+          block.next->prev = block.prev;
+        }
+      }
+
+      instrument_counts drain()
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        instrument_counts counts = m_pending;
+        m_pending = {};
+
+        for (instrument_block* b = m_head; b != nullptr; b = b->next)
+        {
+          collect(*b, counts);
+        }
+
+        return counts;
+      }
+
+    private:
+      static void collect(instrument_block& block, instrument_counts& counts) noexcept
+      {
+        for (std::size_t i = 0; i < instrument_counter_count; ++i)
+        {
+          std::uint64_t const value = block.values[i].load(std::memory_order_relaxed);
+          counts.values[i] += value - block.drained[i];
+          block.drained[i] = value;
+        }
+      }
+
+      std::mutex m_mutex;
+      instrument_block* m_head = nullptr;
+      instrument_counts m_pending;
+    };
+
+    inline instrument_registry& get_instrument_registry()
+    {
+      static instrument_registry registry;
+      return registry;
+    }
+
+    class instrument_thread
+    {
+    public:
+      instrument_thread()
+      {
+        get_instrument_registry().attach(m_block);
+      }
+
+      instrument_thread(instrument_thread const&) = delete;
+      instrument_thread& operator=(instrument_thread const&) = delete;
+
+      ~instrument_thread()
+      {
+        get_instrument_registry().detach(m_block);
+      }
+
+      instrument_block& block() noexcept
+      {
+        return m_block;
+      }
+
+    private:
+      instrument_block m_block;
+    };
+
+    inline void count_at_run_time(instrument_counter counter) noexcept
+    {
+      thread_local instrument_thread thread;
+
+      auto& value = thread.block().values[static_cast<std::size_t>(counter)];
+      value.store(value.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    // Counting is skipped during constant evaluation, where it is not allowed.
+    constexpr void count(instrument_counter counter) noexcept
+    {
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+      if (__builtin_is_constant_evaluated())
+      {
+        return;
+      }
+#endif
+#endif
+      count_at_run_time(counter);
+    }
+  } // namespace detail
+
+  // Returns the number of times each counter was incremented, by any thread,
+  // since the previous call.
+  inline instrument_counts drain_instrument_counters()
+  {
+    return detail::get_instrument_registry().drain();
+  }
+
+#define GSL_POINTERS_COUNT(counter) \
+  ::gsl::detail::count(::gsl::instrument_counter::counter)
+
+#define GSL_POINTERS_COUNTED(counter, expression) \
+  (::gsl::detail::count(::gsl::instrument_counter::counter), (expression))
+
+#else
+  // Returns no counts when instrumentation is disabled.
+  inline instrument_counts drain_instrument_counters() noexcept
+  {
+    return {};
+  }
+
+#define GSL_POINTERS_COUNT(counter) static_cast<void>(0)
+
+#define GSL_POINTERS_COUNTED(counter, expression) (expression)
+#endif
+
+} // namespace gsl
+
+#endif // GSL_INSTRUMENT_HPP
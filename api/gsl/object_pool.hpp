@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GSL_OBJECT_POOL_HPP
+#define GSL_OBJECT_POOL_HPP
+
+#include "optional_ref.hpp"
+#include "optional_retained.hpp"
+#include "retained.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gsl
+{
+  template <typename T>
+  class object_pool;
+
+  // A handle to an object in an `object_pool<T>`, consisting of the index of its
+  // slot and the generation of the slot when the object was created. A handle
+  // can be checked against the pool to find out whether the object still
+  // exists. Default-constructed handles never refer to an object.
+  //
+  // A `retained_handle<T>` converts to a `retained_handle<T const>`, through
+  // which the pool only gives const access to the object, but not the reverse.
+  // As with `const_iterator`, an object can still be erased through a const
+  // handle.
+  template <typename T>
+  class retained_handle
+  {
+    friend class object_pool<std::remove_const_t<T>>;
+
+  public:
+    constexpr retained_handle() noexcept
+    : m_index()
+    , m_generation()
+    {
+    }
+
+    template <typename U, typename = std::enable_if_t<std::is_same_v<U const, T>>>
+    constexpr retained_handle(retained_handle<U> const& other) noexcept
+    : m_index(other.index())
+    , m_generation(other.generation())
+    {
+    }
+
+    constexpr std::uint32_t index() const noexcept
+    {
+      return m_index;
+    }
+
+    constexpr std::uint32_t generation() const noexcept
+    {
+      return m_generation;
+    }
+
+  private:
+    constexpr retained_handle(std::uint32_t index, std::uint32_t generation) noexcept
+    : m_index(index)
+    , m_generation(generation)
+    {
+    }
+
+    std::uint32_t m_index;
+    std::uint32_t m_generation;
+  };
+
+  template <typename T1, typename T2>
+  constexpr bool operator==(
+      retained_handle<T1> const& lhs, retained_handle<T2> const& rhs) noexcept
+  {
+    return lhs.index() == rhs.index() && lhs.generation() == rhs.generation();
+  }
+
+  template <typename T1, typename T2>
+  constexpr bool operator!=(
+      retained_handle<T1> const& lhs, retained_handle<T2> const& rhs) noexcept
+  {
+    return !(lhs == rhs);
+  }
+
+  // A fixed-capacity pool of `T` objects stored contiguously, which hands out
+  // `retained_handle<T>`s rather than pointers. Checking a handle is a bounds
+  // check and a comparison of its generation with that of its slot, with no
+  // atomic operations. A slot's generation is odd while it holds an object.
+  //
+  // Objects are never moved, so references obtained through a handle remain
+  // valid until the object is erased.
+  template <typename T>
+  class object_pool
+  {
+    static_assert(!std::is_const_v<T> && !std::is_reference_v<T>);
+
+  public:
+    using value_type = T;
+    using handle = retained_handle<T>;
+    using const_handle = retained_handle<T const>;
+    using size_type = std::uint32_t;
+
+    explicit object_pool(size_type capacity)
+    : m_slots(new slot[capacity])
+    , m_generations(std::make_unique<std::uint32_t[]>(capacity))
+    , m_capacity(capacity)
+    {
+      m_free.reserve(capacity);
+
+      // Slots are handed out lowest index first, and reused most recently
+      // freed first.
+      for (size_type i = capacity; i != 0; --i)
+      {
+        m_free.push_back(i - 1);
+      }
+    }
+
+    object_pool(object_pool const&) = delete;
+    object_pool& operator=(object_pool const&) = delete;
+
+    ~object_pool()
+    {
+      clear();
+    }
+
+    // Creates an object from `args` and returns a handle to it, or returns a
+    // default-constructed handle, which refers to no object, if the pool is full.
+    template <typename... Args>
+    handle emplace(Args&&... args)
+    {
+      if (m_free.empty())
+      {
+        return handle();
+      }
+
+      size_type const i = m_free.back();
+      ::new (static_cast<void*>(m_slots[i].bytes)) T(std::forward<Args>(args)...);
+      m_free.pop_back();
+      ++m_size;
+
+      return handle(i, ++m_generations[i]);
+    }
+
+    // Destroys the object referenced by `h`, if it still exists, and returns
+    // whether it did.
+    bool erase(const_handle h) noexcept
+    {
+      if (!contains(h))
+      {
+        return false;
+      }
+
+      std::destroy_at(object(h.index()));
+      --m_size;
+
+      // A slot whose generation would wrap around is retired, so that old
+      // handles can never refer to a new object.
+      if (++m_generations[h.index()] != 0)
+      {
+        m_free.push_back(h.index());
+      }
+
+      return true;
+    }
+
+    void clear() noexcept
+    {
+      for (size_type i = 0; i != m_capacity && m_size != 0; ++i)
+      {
+        if (m_generations[i] % 2 != 0)
+        {
+          erase(const_handle(i, m_generations[i]));
+        }
+      }
+    }
+
+    bool contains(const_handle h) const noexcept
+    {
+      return h.index() < m_capacity && m_generations[h.index()] == h.generation()
+          && h.generation() % 2 != 0;
+    }
+
+    optional_ref<T> get(handle h) noexcept
+    {
+      return contains(h) ? optional_ref<T>(*object(h.index())) : std::nullopt;
+    }
+
+    optional_ref<T const> get(const_handle h) const noexcept
+    {
+      return contains(h) ? optional_ref<T const>(*object(h.index())) : std::nullopt;
+    }
+
+    optional_retained<T> retain(handle h) noexcept
+    {
+      return contains(h) ? optional_retained<T>(make_retained(*object(h.index())))
+                         : std::nullopt;
+    }
+
+    optional_retained<T const> retain(const_handle h) const noexcept
+    {
+      return contains(h) ? optional_retained<T const>(make_retained(*object(h.index())))
+                         : std::nullopt;
+    }
+
+    size_type size() const noexcept
+    {
+      return m_size;
+    }
+
+    size_type capacity() const noexcept
+    {
+      return m_capacity;
+    }
+
+    bool empty() const noexcept
+    {
+      return m_size == 0;
+    }
+
+  private:
+    struct slot
+    {
+      alignas(T) unsigned char bytes[sizeof(T)];
+    };
+
+    T* object(size_type i) noexcept
+    {
+      return std::launder(reinterpret_cast<T*>(m_slots[i].bytes));
+    }
+
+    T const* object(size_type i) const noexcept
+    {
+      return std::launder(reinterpret_cast<T const*>(m_slots[i].bytes));
+    }
+
+    std::unique_ptr<slot[]> m_slots;
+    std::unique_ptr<std::uint32_t[]> m_generations;
+    std::vector<size_type> m_free;
+    size_type m_capacity;
+    size_type m_size = 0;
+  };
+} // namespace gsl
+
+namespace std
+{
+  template <typename T>
+  struct hash<gsl::retained_handle<T>>
+  {
+    std::size_t operator()(gsl::retained_handle<T> const& h) const noexcept
+    {
+      return std::hash<std::uint64_t>()(std::uint64_t(h.generation()) << 32 | h.index());
+    }
+  };
+} // namespace std
+
+#endif // GSL_OBJECT_POOL_HPP
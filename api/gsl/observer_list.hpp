@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GSL_OBSERVER_LIST_HPP
+#define GSL_OBSERVER_LIST_HPP
+
+#include "atomic_retained.hpp"
+#include "epoch.hpp"
+#include "retained.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace gsl
+{
+  // A list of observers that can be notified concurrently with subscription
+  // and unsubscription. Notification iterates over an immutable snapshot of
+  // the list and never blocks or retries, and subscription and unsubscription
+  // publish new snapshots with a compare-and-swap. Unsubscribed observers are
+  // only flagged as removed, and are dropped in batches the next time a
+  // snapshot is published. Replaced snapshots are reclaimed through an
+  // `epoch_domain`, so every operation requires an `epoch_guard` pinning it.
+  //
+  // Subscription and unsubscription take no locks: replaced snapshots are
+  // retired with `epoch_domain::retire_lock_free`, and reclaimed by whichever
+  // thread next collects the domain. Subscription does allocate, so it is
+  // only as lock-free as the allocator.
+  //
+  // A notification that is already in progress when `unsubscribe` returns may
+  // still call the observer. An observer must therefore outlive every guard
+  // that was pinned before it was unsubscribed.
+  template <typename T>
+  class observer_list
+  {
+    struct entry : epoch_domain::retire_hook
+    {
+      explicit entry(retained<T> observer) noexcept
+      : observer(std::move(observer))
+      {
+      }
+
+      retained<T> observer;
+      std::atomic<bool> removed = {false};
+    };
+
+    struct snapshot : epoch_domain::retire_hook
+    {
+      std::vector<entry*> entries;
+    };
+
+  public:
+    explicit observer_list(epoch_domain& domain)
+    : m_domain(domain)
+    , m_snapshot(make_retained(*new snapshot()))
+    {
+    }
+
+    observer_list(observer_list const&) = delete;
+    observer_list& operator=(observer_list const&) = delete;
+
+    // No guard may be pinned while the list is destroyed.
+    ~observer_list()
+    {
+      snapshot* current = std::addressof(*m_snapshot.load(std::memory_order_acquire));
+
+      for (entry* e : current->entries)
+      {
+        delete e;
+      }
+
+      delete current;
+    }
+
+    // Adds `observer` to the list. An observer can be subscribed more than once,
+    // in which case it is notified once per subscription.
+    void subscribe(epoch_guard const& guard, retained<T> observer)
+    {
+      auto added = std::make_unique<entry>(std::move(observer));
+      publish(guard, added.get());
+      added.release();
+    }
+
+    // Removes one subscription of `observer`. Returns `false` if `observer` is
+    // not subscribed.
+    bool unsubscribe(epoch_guard const& guard, T const& observer)
+    {
+      snapshot const& current = *m_snapshot.load(std::memory_order_acquire);
+      std::size_t const size = current.entries.size();
+
+      for (entry* e : current.entries)
+      {
+        if (std::addressof(*e->observer) != std::addressof(observer))
+        {
+          continue;
+        }
+
+        bool expected = false;
+
+        if (e->removed.compare_exchange_strong(expected, true, std::memory_order_relaxed))
+        {
+          std::ptrdiff_t const removed =
+              m_removed.fetch_add(1, std::memory_order_relaxed) + 1;
+
+          if (removed >= compaction_threshold
+              || static_cast<std::size_t>(removed) * 2 >= size)
+          {
+            publish(guard, nullptr);
+          }
+
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+    // Calls `f(observer)` for every subscribed observer.
+    template <typename F>
+    void notify(epoch_guard const&, F&& f)
+    {
+      snapshot const& current = *m_snapshot.load(std::memory_order_acquire);
+
+      for (entry* e : current.entries)
+      {
+        if (!e->removed.load(std::memory_order_relaxed))
+        {
+          f(*e->observer);
+        }
+      }
+    }
+
+    // Returns the number of subscriptions.
+    std::size_t size(epoch_guard const&) const noexcept
+    {
+      snapshot const& current = *m_snapshot.load(std::memory_order_acquire);
+      std::size_t count = 0;
+
+      for (entry const* e : current.entries)
+      {
+        count += !e->removed.load(std::memory_order_relaxed);
+      }
+
+      return count;
+    }
+
+    epoch_domain& domain() const noexcept
+    {
+      return m_domain;
+    }
+
+  private:
+    static constexpr std::ptrdiff_t compaction_threshold = 64;
+
+    // Publishes a copy of the current snapshot without its removed entries and
+    // with `added` appended, and retires the replaced snapshot and the entries
+    // that it dropped.
+    void publish(epoch_guard const&, entry* added)
+    {
+      retained<snapshot> current = m_snapshot.load(std::memory_order_acquire);
+      std::unique_ptr<snapshot> next;
+
+      do
+      {
+        next = std::make_unique<snapshot>();
+        next->entries.reserve(current->entries.size() + 1);
+
+        for (entry* e : current->entries)
+        {
+          if (!e->removed.load(std::memory_order_relaxed))
+          {
+            next->entries.push_back(e);
+          }
+        }
+
+        if (added != nullptr)
+        {
+          next->entries.push_back(added);
+        }
+      } while (!m_snapshot.compare_exchange_weak(
+          current,
+          make_retained(*next),
+          std::memory_order_acq_rel,
+          std::memory_order_acquire));
+
+      // Entries are copied in order, so those that were dropped are the ones
+      // missing from the new snapshot. An entry flagged as removed after it
+      // was copied stays in the new snapshot until the next publication.
+      snapshot const& published = *next.release();
+      auto kept = published.entries.begin();
+      std::ptrdiff_t dropped = 0;
+
+      for (entry* e : current->entries)
+      {
+        if (kept != published.entries.end() && *kept == e)
+        {
+          ++kept;
+        }
+        else
+        {
+          m_domain.retire_lock_free(e);
+          ++dropped;
+        }
+      }
+
+      m_removed.fetch_sub(dropped, std::memory_order_relaxed);
+      m_domain.retire_lock_free(std::addressof(*current));
+    }
+
+    epoch_domain& m_domain;
+    atomic_retained<snapshot> m_snapshot;
+    std::atomic<std::ptrdiff_t> m_removed = {0};
+  };
+
+} // namespace gsl
+
+#endif // GSL_OBSERVER_LIST_HPP
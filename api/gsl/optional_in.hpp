@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GSL_OPTIONAL_IN_HPP
+#define GSL_OPTIONAL_IN_HPP
+
+#include "contract.hpp"
+#include "optional_ref.hpp"
+
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace gsl
+{
+  namespace detail
+  {
+    // An optional input parameter that holds a copy of its value, so that it can
+    // be passed in registers rather than through memory.
+    template <typename T>
+    class optional_in_value
+    {
+    public:
+      using value_type = T const&;
+
+      constexpr optional_in_value() noexcept
+      : m_none()
+      , m_engaged(false)
+      {
+      }
+
+      constexpr optional_in_value(std::nullopt_t) noexcept
+      : m_none()
+      , m_engaged(false)
+      {
+      }
+
+      constexpr optional_in_value(T const& t) noexcept
+      : m_value(t)
+      , m_engaged(true)
+      {
+      }
+
+      template <
+          typename U,
+          typename = std::enable_if_t<std::is_same_v<std::remove_cv_t<U>, T>>>
+      constexpr optional_in_value(optional_ref<U> const& other) noexcept
+      : optional_in_value(other ? optional_in_value(*other) : optional_in_value())
+      {
+      }
+
+      constexpr bool has_value() const noexcept
+      {
+        return m_engaged;
+      }
+
+      constexpr explicit operator bool() const noexcept
+      {
+        return has_value();
+      }
+
+      constexpr T const& operator*() const
+      {
+        detail::expect_dereferenceable(has_value());
+        return m_value;
+      }
+
+      constexpr T const* operator->() const
+      {
+        detail::expect_dereferenceable(has_value());
+        return &m_value;
+      }
+
+      constexpr T const& value() const
+      {
+        detail::expect_engaged(has_value());
+
+        return m_value;
+      }
+
+      template <typename U>
+      constexpr T value_or(U&& default_value) const
+      {
+        return has_value() ? m_value : static_cast<T>(std::forward<U>(default_value));
+      }
+
+      constexpr T const& value_or_ref(T const& fallback) const noexcept
+      {
+        return has_value() ? m_value : fallback;
+      }
+
+      // As with `optional_ref`, a temporary fallback would dangle.
+      T const& value_or_ref(T const&&) const = delete;
+
+    private:
+      union
+      {
+        char m_none;
+        T m_value;
+      };
+
+      bool m_engaged;
+    };
+
+    template <typename T>
+    constexpr bool operator==(optional_in_value<T> const& opt, std::nullopt_t) noexcept
+    {
+      return !opt;
+    }
+
+    template <typename T>
+    constexpr bool operator==(std::nullopt_t, optional_in_value<T> const& opt) noexcept
+    {
+      return !opt;
+    }
+
+    template <typename T>
+    constexpr bool operator!=(optional_in_value<T> const& opt, std::nullopt_t) noexcept
+    {
+      return bool(opt);
+    }
+
+    template <typename T>
+    constexpr bool operator!=(std::nullopt_t, optional_in_value<T> const& opt) noexcept
+    {
+      return bool(opt);
+    }
+
+    template <typename T>
+    constexpr bool operator==(optional_in_value<T> const& opt, T const& value)
+    {
+      return bool(opt) ? *opt == value : false;
+    }
+
+    template <typename T>
+    constexpr bool operator==(T const& value, optional_in_value<T> const& opt)
+    {
+      return bool(opt) ? value == *opt : false;
+    }
+
+    template <typename T>
+    constexpr bool operator!=(optional_in_value<T> const& opt, T const& value)
+    {
+      return bool(opt) ? *opt != value : true;
+    }
+
+    template <typename T>
+    constexpr bool operator!=(T const& value, optional_in_value<T> const& opt)
+    {
+      return bool(opt) ? value != *opt : true;
+    }
+
+    template <typename T>
+    constexpr bool is_passed_in_registers_v =
+        std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(void*);
+  } // namespace detail
+
+  // An optional input parameter of type `T`. Small trivially copyable types are
+  // held by value so that they can be passed in registers; other types are
+  // referenced with `optional_ref<T const>`. Both bind to temporaries.
+  template <typename T>
+  using optional_in = std::conditional_t<
+      detail::is_passed_in_registers_v<std::remove_cv_t<T>>,
+      detail::optional_in_value<std::remove_cv_t<T>>,
+      optional_ref<T const>>;
+
+} // namespace gsl
+
+#endif // GSL_OPTIONAL_IN_HPP
@@ -0,0 +1,556 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GSL_OPTIONAL_REF_CORE_HPP
+#define GSL_OPTIONAL_REF_CORE_HPP
+
+#include "contract.hpp"
+#include "instrument.hpp"
+#include "relocatable_traits.hpp"
+#include "utility.hpp"
+
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#if __has_include(<version>)
+#include <version>
+#endif
+
+#if defined(__cpp_lib_three_way_comparison)
+#include <compare>
+#endif
+
+#if defined(__cpp_impl_three_way_comparison) && defined(__cpp_lib_three_way_comparison)
+#define GSL_POINTERS_THREE_WAY_COMPARISON 1
+#endif
+
+namespace gsl
+{
+  namespace detail
+  {
+    struct optional_ref_access;
+  } // namespace detail
+
+  template <typename T>
+  class GSL_TRIVIALLY_RELOCATABLE optional_ref
+  {
+    template <typename>
+    friend class optional_ref;
+
+    friend struct detail::optional_ref_access;
+
+  public:
+    using value_type = T&;
+
+    constexpr optional_ref() noexcept
+    : m_ptr()
+    {
+    }
+
+    constexpr optional_ref(std::nullopt_t) noexcept
+    : m_ptr()
+    {
+    }
+
+    constexpr optional_ref(T& t) noexcept
+    : m_ptr(detail::addressof(t))
+    {
+      // Arrays of `optional_ref<T>` can be viewed as arrays of `T*`; see
+      // `as_pointers`.
+      static_assert(std::is_standard_layout_v<optional_ref>);
+      static_assert(sizeof(optional_ref) == sizeof(T*));
+      static_assert(alignof(optional_ref) == alignof(T*));
+    }
+
+    optional_ref& operator=(optional_ref const&) = delete;
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    constexpr optional_ref(optional_ref<U> const& other) noexcept
+    : m_ptr(other.m_ptr)
+    {
+    }
+
+    constexpr bool has_value() const noexcept
+    {
+      GSL_POINTERS_COUNT(engagement_check);
+      return m_ptr != nullptr;
+    }
+
+    constexpr explicit operator bool() const noexcept
+    {
+      return has_value();
+    }
+
+    constexpr T& operator*() const
+    {
+      GSL_POINTERS_COUNT(dereference);
+      detail::expect_dereferenceable(m_ptr != nullptr);
+      return *m_ptr;
+    }
+
+    constexpr T* operator->() const
+    {
+      GSL_POINTERS_COUNT(dereference);
+      detail::expect_dereferenceable(m_ptr != nullptr);
+      return m_ptr;
+    }
+
+    constexpr T& value() const
+    {
+      if (m_ptr == nullptr)
+      {
+        GSL_POINTERS_COUNT(value_failure);
+      }
+
+      detail::expect_engaged(m_ptr != nullptr);
+
+      return *m_ptr;
+    }
+
+    template <
+        typename U,
+        typename T_ = T,
+        typename = std::enable_if_t<std::is_copy_constructible_v<T_>>>
+    constexpr T_ value_or(U&& default_value) const
+    {
+      GSL_POINTERS_COUNT(value_or_copy);
+      return m_ptr != nullptr ? *m_ptr : static_cast<T>(std::forward<U>(default_value));
+    }
+
+    // Returns a reference to `fallback` if disengaged, without copying either
+    // object.
+    constexpr T& value_or_ref(T& fallback) const noexcept
+    {
+      return m_ptr != nullptr ? *m_ptr : fallback;
+    }
+
+    T& value_or_ref(T&&) const = delete;
+
+    // Returns the result of invoking `f` with the referenced object, which must
+    // be an optional type, or a disengaged optional of that type.
+    template <typename F>
+    constexpr auto and_then(F&& f) const
+    {
+      using result =
+          std::remove_cv_t<std::remove_reference_t<std::invoke_result_t<F, T&>>>;
+
+      if (m_ptr != nullptr)
+      {
+        return result(detail::invoke(std::forward<F>(f), *m_ptr));
+      }
+
+      return result();
+    }
+
+    // Returns the result of invoking `f` with the referenced object as an
+    // `optional_ref<U>` if it is an lvalue of type `U`, such as a member of the
+    // object, or as an `std::optional<U>` otherwise.
+    template <typename F>
+    constexpr auto transform(F&& f) const
+    {
+      using result = std::invoke_result_t<F, T&>;
+
+      if constexpr (std::is_lvalue_reference_v<result>)
+      {
+        using U = std::remove_reference_t<result>;
+
+        if (m_ptr != nullptr)
+        {
+          return optional_ref<U>(detail::invoke(std::forward<F>(f), *m_ptr));
+        }
+
+        return optional_ref<U>();
+      }
+      else
+      {
+        using U = std::remove_cv_t<std::remove_reference_t<result>>;
+
+        if (m_ptr != nullptr)
+        {
+          return std::optional<U>(detail::invoke(std::forward<F>(f), *m_ptr));
+        }
+
+        return std::optional<U>();
+      }
+    }
+
+    // Returns this if engaged, or the result of invoking `f` otherwise.
+    template <typename F>
+    constexpr optional_ref or_else(F&& f) const
+    {
+      if (m_ptr != nullptr)
+      {
+        return *this;
+      }
+
+      return detail::invoke(std::forward<F>(f));
+    }
+
+  private:
+    T* m_ptr;
+  };
+
+  // Relocating an `optional_ref<T>` only copies the pointer it holds.
+  template <typename T>
+  struct is_trivially_relocatable<optional_ref<T>> : std::true_type
+  {
+  };
+
+  template <typename T>
+  constexpr optional_ref<T> make_optional_ref(T& t) noexcept
+  {
+    return t;
+  }
+
+  // Views an array of `optional_ref<T>` as an array of `T*`, in which
+  // disengaged elements are null, without copying.
+  template <typename T>
+  T* const* as_pointers(optional_ref<T> const* p) noexcept
+  {
+    return reinterpret_cast<T* const*>(p);
+  }
+
+  // Views an array of `T*` as an array of `optional_ref<T>` without copying.
+  template <typename T>
+  optional_ref<T> const* as_optional_refs(T* const* p) noexcept
+  {
+    return reinterpret_cast<optional_ref<T> const*>(p);
+  }
+
+  namespace detail
+  {
+    // Gives the comparison operators access to the pointer held by an
+    // `optional_ref`, so that their own engagement checks and dereferences are
+    // not counted.
+    struct optional_ref_access
+    {
+      template <typename T>
+      static constexpr T* get(optional_ref<T> const& opt) noexcept
+      {
+        return opt.m_ptr;
+      }
+    };
+
+    template <typename T>
+    constexpr T* get_pointer(optional_ref<T> const& opt) noexcept
+    {
+      return optional_ref_access::get(opt);
+    }
+
+    template <typename T>
+    constexpr bool engaged(optional_ref<T> const& opt) noexcept
+    {
+      return get_pointer(opt) != nullptr;
+    }
+  } // namespace detail
+
+  template <typename T>
+  constexpr bool operator==(optional_ref<T> const& lhs, optional_ref<T> const& rhs)
+  {
+    auto const l = detail::get_pointer(lhs);
+    auto const r = detail::get_pointer(rhs);
+
+    return l && r ? GSL_POINTERS_COUNTED(deep_comparison, *l == *r) : bool(l) == bool(r);
+  }
+
+  template <typename T>
+  constexpr bool operator!=(optional_ref<T> const& lhs, optional_ref<T> const& rhs)
+  {
+    auto const l = detail::get_pointer(lhs);
+    auto const r = detail::get_pointer(rhs);
+
+    return l && r ? GSL_POINTERS_COUNTED(deep_comparison, *l != *r) : bool(l) != bool(r);
+  }
+
+  template <typename T>
+  constexpr bool operator==(optional_ref<T> const& opt, std::nullopt_t) noexcept
+  {
+    return !detail::engaged(opt);
+  }
+
+  template <typename T>
+  constexpr bool operator==(std::nullopt_t, optional_ref<T> const& opt) noexcept
+  {
+    return !detail::engaged(opt);
+  }
+
+  template <typename T>
+  constexpr bool operator!=(optional_ref<T> const& opt, std::nullopt_t) noexcept
+  {
+    return detail::engaged(opt);
+  }
+
+  template <typename T>
+  constexpr bool operator!=(std::nullopt_t, optional_ref<T> const& opt) noexcept
+  {
+    return detail::engaged(opt);
+  }
+
+  template <typename T>
+  constexpr bool operator==(optional_ref<T> const& opt, T const& value)
+  {
+    auto const p = detail::get_pointer(opt);
+
+    return p ? GSL_POINTERS_COUNTED(deep_comparison, *p == value) : false;
+  }
+
+  template <typename T>
+  constexpr bool operator==(T const& value, optional_ref<T> const& opt)
+  {
+    auto const p = detail::get_pointer(opt);
+
+    return p ? GSL_POINTERS_COUNTED(deep_comparison, value == *p) : false;
+  }
+
+  template <typename T>
+  constexpr bool operator!=(optional_ref<T> const& opt, T const& value)
+  {
+    auto const p = detail::get_pointer(opt);
+
+    return p ? GSL_POINTERS_COUNTED(deep_comparison, *p != value) : true;
+  }
+
+  template <typename T>
+  constexpr bool operator!=(T const& value, optional_ref<T> const& opt)
+  {
+    auto const p = detail::get_pointer(opt);
+
+    return p ? GSL_POINTERS_COUNTED(deep_comparison, value != *p) : true;
+  }
+
+#if defined(GSL_POINTERS_THREE_WAY_COMPARISON)
+  namespace detail
+  {
+    // Compares with `<=>` if possible, and otherwise synthesizes a weak ordering
+    // from `<`, so that each element is compared only once.
+    struct synth_three_way
+    {
+      template <typename T, typename U>
+      constexpr auto operator()(T const& t, U const& u) const
+      {
+        if constexpr (std::three_way_comparable_with<T, U>)
+        {
+          return t <=> u;
+        }
+        else
+        {
+          return (t < u) ? std::weak_ordering::less
+              : (u < t)  ? std::weak_ordering::greater
+                         : std::weak_ordering::equivalent;
+        }
+      }
+    };
+
+    template <typename T, typename U = T>
+    using synth_three_way_result =
+        decltype(synth_three_way()(std::declval<T const&>(), std::declval<U const&>()));
+  } // namespace detail
+
+  template <typename T>
+  constexpr detail::synth_three_way_result<T> operator<=>(
+      optional_ref<T> const& lhs, optional_ref<T> const& rhs)
+  {
+    auto const l = detail::get_pointer(lhs);
+    auto const r = detail::get_pointer(rhs);
+
+    if (l && r)
+    {
+      return GSL_POINTERS_COUNTED(deep_comparison, detail::synth_three_way()(*l, *r));
+    }
+
+    return bool(l) <=> bool(r);
+  }
+
+  template <typename T>
+  constexpr std::strong_ordering operator<=>(
+      optional_ref<T> const& opt, std::nullopt_t) noexcept
+  {
+    return detail::engaged(opt) <=> false;
+  }
+
+  template <typename T>
+  constexpr detail::synth_three_way_result<T> operator<=>(
+      optional_ref<T> const& opt, T const& value)
+  {
+    auto const p = detail::get_pointer(opt);
+
+    if (p)
+    {
+      return GSL_POINTERS_COUNTED(deep_comparison, detail::synth_three_way()(*p, value));
+    }
+
+    return std::strong_ordering::less;
+  }
+#else
+  template <typename T>
+  constexpr bool operator<(optional_ref<T> const& lhs, optional_ref<T> const& rhs)
+  {
+    auto const l = detail::get_pointer(lhs);
+    auto const r = detail::get_pointer(rhs);
+
+    return l && r ? GSL_POINTERS_COUNTED(deep_comparison, *l < *r) : bool(l) < bool(r);
+  }
+
+  template <typename T>
+  constexpr bool operator<=(optional_ref<T> const& lhs, optional_ref<T> const& rhs)
+  {
+    auto const l = detail::get_pointer(lhs);
+    auto const r = detail::get_pointer(rhs);
+
+    return l && r ? GSL_POINTERS_COUNTED(deep_comparison, *l <= *r) : bool(l) <= bool(r);
+  }
+
+  template <typename T>
+  constexpr bool operator>(optional_ref<T> const& lhs, optional_ref<T> const& rhs)
+  {
+    auto const l = detail::get_pointer(lhs);
+    auto const r = detail::get_pointer(rhs);
+
+    return l && r ? GSL_POINTERS_COUNTED(deep_comparison, *l > *r) : bool(l) > bool(r);
+  }
+
+  template <typename T>
+  constexpr bool operator>=(optional_ref<T> const& lhs, optional_ref<T> const& rhs)
+  {
+    auto const l = detail::get_pointer(lhs);
+    auto const r = detail::get_pointer(rhs);
+
+    return l && r ? GSL_POINTERS_COUNTED(deep_comparison, *l >= *r) : bool(l) >= bool(r);
+  }
+
+  template <typename T>
+  constexpr bool operator<(optional_ref<T> const& opt, std::nullopt_t) noexcept
+  {
+    return false;
+  }
+
+  template <typename T>
+  constexpr bool operator<(std::nullopt_t, optional_ref<T> const& opt) noexcept
+  {
+    return detail::engaged(opt);
+  }
+
+  template <typename T>
+  constexpr bool operator<=(optional_ref<T> const& opt, std::nullopt_t) noexcept
+  {
+    return !detail::engaged(opt);
+  }
+
+  template <typename T>
+  constexpr bool operator<=(std::nullopt_t, optional_ref<T> const& opt) noexcept
+  {
+    return true;
+  }
+
+  template <typename T>
+  constexpr bool operator>(optional_ref<T> const& opt, std::nullopt_t) noexcept
+  {
+    return detail::engaged(opt);
+  }
+
+  template <typename T>
+  constexpr bool operator>(std::nullopt_t, optional_ref<T> const& opt) noexcept
+  {
+    return false;
+  }
+
+  template <typename T>
+  constexpr bool operator>=(optional_ref<T> const& opt, std::nullopt_t) noexcept
+  {
+    return true;
+  }
+
+  template <typename T>
+  constexpr bool operator>=(std::nullopt_t, optional_ref<T> const& opt) noexcept
+  {
+    return !detail::engaged(opt);
+  }
+
+  template <typename T>
+  constexpr bool operator<(optional_ref<T> const& opt, T const& value)
+  {
+    auto const p = detail::get_pointer(opt);
+
+    return p ? GSL_POINTERS_COUNTED(deep_comparison, *p < value) : true;
+  }
+
+  template <typename T>
+  constexpr bool operator<(T const& value, optional_ref<T> const& opt)
+  {
+    auto const p = detail::get_pointer(opt);
+
+    return p ? GSL_POINTERS_COUNTED(deep_comparison, value < *p) : false;
+  }
+
+  template <typename T>
+  constexpr bool operator<=(optional_ref<T> const& opt, T const& value)
+  {
+    auto const p = detail::get_pointer(opt);
+
+    return p ? GSL_POINTERS_COUNTED(deep_comparison, *p <= value) : true;
+  }
+
+  template <typename T>
+  constexpr bool operator<=(T const& value, optional_ref<T> const& opt)
+  {
+    auto const p = detail::get_pointer(opt);
+
+    return p ? GSL_POINTERS_COUNTED(deep_comparison, value <= *p) : false;
+  }
+
+  template <typename T>
+  constexpr bool operator>(optional_ref<T> const& opt, T const& value)
+  {
+    auto const p = detail::get_pointer(opt);
+
+    return p ? GSL_POINTERS_COUNTED(deep_comparison, *p > value) : false;
+  }
+
+  template <typename T>
+  constexpr bool operator>(T const& value, optional_ref<T> const& opt)
+  {
+    auto const p = detail::get_pointer(opt);
+
+    return p ? GSL_POINTERS_COUNTED(deep_comparison, value > *p) : true;
+  }
+
+  template <typename T>
+  constexpr bool operator>=(optional_ref<T> const& opt, T const& value)
+  {
+    auto const p = detail::get_pointer(opt);
+
+    return p ? GSL_POINTERS_COUNTED(deep_comparison, *p >= value) : false;
+  }
+
+  template <typename T>
+  constexpr bool operator>=(T const& value, optional_ref<T> const& opt)
+  {
+    auto const p = detail::get_pointer(opt);
+
+    return p ? GSL_POINTERS_COUNTED(deep_comparison, value >= *p) : true;
+  }
+#endif
+
+} // namespace gsl
+
+#endif // GSL_OPTIONAL_REF_CORE_HPP
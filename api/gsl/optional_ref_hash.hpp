@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GSL_OPTIONAL_REF_HASH_HPP
+#define GSL_OPTIONAL_REF_HASH_HPP
+
+#include "optional_ref_core.hpp"
+#include "retained_hash.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+
+namespace gsl
+{
+  namespace detail
+  {
+    // Maps each of the key types accepted by the identity comparators and
+    // hashers of `optional_ref` to the address of the referenced object, or to
+    // null if there is none.
+    template <typename T>
+    constexpr void const* identity_address(optional_ref<T> const& opt) noexcept
+    {
+      return get_pointer(opt);
+    }
+
+    template <typename T>
+    constexpr void const* identity_address(T* p) noexcept
+    {
+      return p;
+    }
+
+    constexpr void const* identity_address(std::nullopt_t) noexcept
+    {
+      return nullptr;
+    }
+
+    template <typename K>
+    using identity_key_t = decltype(identity_address(std::declval<K const&>()));
+  } // namespace detail
+
+  // Comparators and a hash function for `optional_ref`s that consider only the
+  // identity of the referenced objects, rather than their values. Unlike the
+  // comparison operators and `std::hash<optional_ref<T>>`, they take constant
+  // time and do not require `T` to be comparable or hashable. They are
+  // transparent, so containers using them can be searched with pointers and
+  // `std::nullopt`.
+  struct identity_equal_to
+  {
+    using is_transparent = void;
+
+    template <
+        typename K1,
+        typename K2,
+        typename = detail::identity_key_t<K1>,
+        typename = detail::identity_key_t<K2>>
+    constexpr bool operator()(K1 const& lhs, K2 const& rhs) const noexcept
+    {
+      return detail::identity_address(lhs) == detail::identity_address(rhs);
+    }
+  };
+
+  struct identity_less
+  {
+    using is_transparent = void;
+
+    template <
+        typename K1,
+        typename K2,
+        typename = detail::identity_key_t<K1>,
+        typename = detail::identity_key_t<K2>>
+    constexpr bool operator()(K1 const& lhs, K2 const& rhs) const noexcept
+    {
+      return std::less<void const*>()(
+          detail::identity_address(lhs), detail::identity_address(rhs));
+    }
+  };
+
+  struct identity_hash
+  {
+    using is_transparent = void;
+
+    template <typename K, typename = detail::identity_key_t<K>>
+    std::size_t operator()(K const& k) const noexcept
+    {
+      return static_cast<std::size_t>(detail::mix_address_bits(
+          reinterpret_cast<std::uintptr_t>(detail::identity_address(k))));
+    }
+  };
+
+} // namespace gsl
+
+namespace std
+{
+  template <typename T>
+  struct hash<gsl::optional_ref<T>>
+  {
+    constexpr std::size_t operator()(gsl::optional_ref<T> const& opt) const noexcept
+    {
+      T const* const p = gsl::detail::get_pointer(opt);
+      return p != nullptr ? hash<T>()(*p) : hash<void*>()(nullptr);
+    }
+  };
+
+} // namespace std
+
+#endif // GSL_OPTIONAL_REF_HASH_HPP
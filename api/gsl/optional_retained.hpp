@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GSL_OPTIONAL_RETAINED_HPP
+#define GSL_OPTIONAL_RETAINED_HPP
+
+#include "contract.hpp"
+#include "relocatable.hpp"
+#include "retained.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace gsl
+{
+  // An `optional<retained<T>>` that uses the unused null state of the pointer
+  // internal to `retained<T>` to represent its disengaged state, so that it
+  // occupies no more memory than `T*`. As with `optional_ref<T>`, the value is
+  // accessed as a `T&`, which is its `value_type`.
+  template <typename T>
+  class GSL_TRIVIALLY_RELOCATABLE optional_retained
+  {
+    template <typename>
+    friend class optional_retained;
+
+  public:
+    using value_type = T&;
+    using element_type = T;
+
+    constexpr optional_retained() noexcept
+    : m_ptr()
+    {
+    }
+
+    constexpr optional_retained(std::nullopt_t) noexcept
+    : m_ptr()
+    {
+    }
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    constexpr optional_retained(retained<U>&& r) noexcept
+    : m_ptr(r.m_ptr)
+    {
+    }
+
+    constexpr explicit optional_retained(optional_retained const&) noexcept = delete;
+    constexpr optional_retained(optional_retained&&) noexcept = default;
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    constexpr optional_retained(optional_retained<U>&& other) noexcept
+    : m_ptr(other.m_ptr)
+    {
+    }
+
+    constexpr optional_retained& operator=(optional_retained const&) noexcept = delete;
+    constexpr optional_retained& operator=(optional_retained&&) noexcept = default;
+
+    constexpr optional_retained& operator=(std::nullopt_t) noexcept
+    {
+      m_ptr = nullptr;
+      return *this;
+    }
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    constexpr optional_retained& operator=(retained<U>&& r) noexcept
+    {
+      m_ptr = r.m_ptr;
+      return *this;
+    }
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    constexpr optional_retained& operator=(optional_retained<U>&& other) noexcept
+    {
+      m_ptr = other.m_ptr;
+      return *this;
+    }
+
+    constexpr bool has_value() const noexcept
+    {
+      return m_ptr != nullptr;
+    }
+
+    constexpr explicit operator bool() const noexcept
+    {
+      return has_value();
+    }
+
+    constexpr T& operator*() noexcept
+    {
+      detail::expect_dereferenceable(has_value());
+      return *m_ptr;
+    }
+
+    constexpr T const& operator*() const noexcept
+    {
+      detail::expect_dereferenceable(has_value());
+      return *m_ptr;
+    }
+
+    constexpr T* operator->() noexcept
+    {
+      detail::expect_dereferenceable(has_value());
+      return m_ptr;
+    }
+
+    constexpr T const* operator->() const noexcept
+    {
+      detail::expect_dereferenceable(has_value());
+      return m_ptr;
+    }
+
+    constexpr T& value()
+    {
+      detail::expect_engaged(has_value());
+
+      return *m_ptr;
+    }
+
+    constexpr T const& value() const
+    {
+      detail::expect_engaged(has_value());
+
+      return *m_ptr;
+    }
+
+    constexpr void reset() noexcept
+    {
+      m_ptr = nullptr;
+    }
+
+    constexpr void swap(optional_retained& other) noexcept
+    {
+      T* const ptr = m_ptr;
+      m_ptr = other.m_ptr;
+      other.m_ptr = ptr;
+    }
+
+  private:
+    T* m_ptr;
+  };
+
+  // Relocating an `optional_retained<T>` only copies the pointer it holds.
+  template <typename T>
+  struct is_trivially_relocatable<optional_retained<T>> : std::true_type
+  {
+  };
+
+  template <typename T>
+  constexpr void swap(optional_retained<T>& lhs, optional_retained<T>& rhs) noexcept
+  {
+    lhs.swap(rhs);
+  }
+
+  template <typename T1, typename T2>
+  constexpr bool
+  operator==(optional_retained<T1> const& lhs, optional_retained<T2> const& rhs) noexcept
+  {
+    return (bool(lhs) != bool(rhs)) ? false
+        : (bool(lhs) == false)      ? true
+                                    : &*lhs == &*rhs;
+  }
+
+  template <typename T1, typename T2>
+  constexpr bool
+  operator!=(optional_retained<T1> const& lhs, optional_retained<T2> const& rhs) noexcept
+  {
+    return !(lhs == rhs);
+  }
+
+  template <typename T1, typename T2>
+  constexpr bool
+  operator==(optional_retained<T1> const& opt, retained<T2> const& r) noexcept
+  {
+    return bool(opt) ? &*opt == &*r : false;
+  }
+
+  template <typename T1, typename T2>
+  constexpr bool
+  operator==(retained<T1> const& r, optional_retained<T2> const& opt) noexcept
+  {
+    return bool(opt) ? &*r == &*opt : false;
+  }
+
+  template <typename T1, typename T2>
+  constexpr bool
+  operator!=(optional_retained<T1> const& opt, retained<T2> const& r) noexcept
+  {
+    return !(opt == r);
+  }
+
+  template <typename T1, typename T2>
+  constexpr bool
+  operator!=(retained<T1> const& r, optional_retained<T2> const& opt) noexcept
+  {
+    return !(r == opt);
+  }
+
+  template <typename T>
+  constexpr bool operator==(optional_retained<T> const& opt, std::nullopt_t) noexcept
+  {
+    return !opt;
+  }
+
+  template <typename T>
+  constexpr bool operator==(std::nullopt_t, optional_retained<T> const& opt) noexcept
+  {
+    return !opt;
+  }
+
+  template <typename T>
+  constexpr bool operator!=(optional_retained<T> const& opt, std::nullopt_t) noexcept
+  {
+    return bool(opt);
+  }
+
+  template <typename T>
+  constexpr bool operator!=(std::nullopt_t, optional_retained<T> const& opt) noexcept
+  {
+    return bool(opt);
+  }
+
+} // namespace gsl
+
+namespace std
+{
+  template <typename T>
+  struct less<gsl::optional_retained<T>>
+  {
+    constexpr bool operator()(
+        gsl::optional_retained<T> const& lhs,
+        gsl::optional_retained<T> const& rhs) const noexcept
+    {
+      return less<T const*>()(lhs ? &*lhs : nullptr, rhs ? &*rhs : nullptr);
+    }
+  };
+
+  template <typename T>
+  struct hash<gsl::optional_retained<T>>
+  {
+    constexpr std::size_t operator()(gsl::optional_retained<T> const& opt) const noexcept
+    {
+      return hash<T const*>()(opt ? &*opt : nullptr);
+    }
+  };
+} // namespace std
+
+#endif // GSL_OPTIONAL_RETAINED_HPP
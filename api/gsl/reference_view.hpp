@@ -0,0 +1,485 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GSL_REFERENCE_VIEW_HPP
+#define GSL_REFERENCE_VIEW_HPP
+
+#include "optional_ref.hpp"
+#include "retained.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#if __has_include(<version>)
+#include <version>
+#endif
+
+#if defined(__cpp_lib_ranges)
+#include <ranges>
+#define GSL_POINTERS_RANGES 1
+#endif
+
+namespace gsl
+{
+  namespace detail
+  {
+    struct to_retained
+    {
+      template <typename U>
+      static constexpr retained<U> apply(U& u) noexcept
+      {
+        static_assert(
+            !std::is_pointer_v<U>,
+            "a range of pointers may contain null; use `views::optional_ref` instead");
+
+        return retained<U>(u);
+      }
+    };
+
+    struct to_optional_ref
+    {
+      template <typename U>
+      static constexpr auto apply(U& u) noexcept
+      {
+        if constexpr (std::is_pointer_v<U>)
+        {
+          using element = std::remove_pointer_t<U>;
+          return u ? optional_ref<element>(*u) : optional_ref<element>(std::nullopt);
+        }
+        else
+        {
+          return optional_ref<U>(u);
+        }
+      }
+    };
+
+#if defined(GSL_POINTERS_RANGES)
+    // The strongest standard iterator category that a view over an iterator of
+    // type `It` can model, given that its references are prvalues.
+    template <typename It>
+    using reference_view_concept = std::conditional_t<
+        std::random_access_iterator<It>,
+        std::random_access_iterator_tag,
+        std::conditional_t<
+            std::bidirectional_iterator<It>,
+            std::bidirectional_iterator_tag,
+            std::conditional_t<
+                std::forward_iterator<It>,
+                std::forward_iterator_tag,
+                std::input_iterator_tag>>>;
+#endif
+  } // namespace detail
+
+  namespace detail
+  {
+    // Whether a reference view stores a range of type `R` by value rather than
+    // by pointer. As with `views::all`, views and borrowed ranges are stored by
+    // value, so that views can be composed from temporaries.
+    template <typename R>
+    inline constexpr bool stores_range_by_value_v =
+#if defined(GSL_POINTERS_RANGES)
+        std::ranges::view<R> || std::ranges::enable_borrowed_range<R>;
+#else
+        false;
+#endif
+
+    template <typename R>
+    using remove_cvref_t = std::remove_cv_t<std::remove_reference_t<R>>;
+
+    // The type of range stored by a reference view of a `R&&`.
+    template <typename R>
+    using reference_view_range_t = std::conditional_t<
+        stores_range_by_value_v<remove_cvref_t<R>>,
+        remove_cvref_t<R>,
+        std::remove_reference_t<R>>;
+
+    // Whether a reference view of a `R&&` can be created. Rvalue containers are
+    // rejected because the view would outlive them.
+    template <typename R, typename = void>
+    struct is_reference_viewable : std::false_type
+    {
+    };
+
+    template <typename R>
+    struct is_reference_viewable<R, std::void_t<decltype(std::begin(std::declval<R&>()))>>
+    : std::bool_constant<
+          std::is_lvalue_reference_v<R> || stores_range_by_value_v<remove_cvref_t<R>>>
+    {
+    };
+  } // namespace detail
+
+  // A view of a range of `T` that yields a `retained<T>` or `optional_ref<T>`
+  // to each element as it is iterated, without materializing a container of
+  // references. A view of a range of `T*` yields `optional_ref<T>`, which is
+  // disengaged for null pointers. Other views are stored by value; any other
+  // range is referred to, and must outlive the view.
+  //
+  // Because elements are produced as prvalues, the iterator only claims to be
+  // an input iterator to C++17 algorithms. Under C++20 ranges, it models the
+  // category of the underlying iterator, up to random access.
+  template <typename Range, typename Adaptor>
+  class reference_view
+#if defined(GSL_POINTERS_RANGES)
+  : public std::ranges::view_interface<reference_view<Range, Adaptor>>
+#endif
+  {
+    static constexpr bool by_value = detail::stores_range_by_value_v<Range>;
+
+    // A stored view is const when the `reference_view` is, but a referenced
+    // range keeps its own constness, as with a pointer.
+    using const_range = std::conditional_t<by_value, Range const, Range>;
+    using stored_range = std::conditional_t<by_value, Range, Range*>;
+
+    template <typename Base>
+    class basic_iterator
+    {
+      using base_iterator = decltype(std::begin(std::declval<Base&>()));
+      using base_traits = std::iterator_traits<base_iterator>;
+
+    public:
+      using iterator_category = std::input_iterator_tag;
+#if defined(GSL_POINTERS_RANGES)
+      using iterator_concept = detail::reference_view_concept<base_iterator>;
+#endif
+      using value_type = decltype(Adaptor::apply(*std::declval<base_iterator const&>()));
+      using difference_type = typename base_traits::difference_type;
+      using pointer = void;
+      using reference = value_type;
+
+      constexpr basic_iterator() = default;
+
+      constexpr explicit basic_iterator(base_iterator it)
+      : m_it(std::move(it))
+      {
+      }
+
+      constexpr base_iterator const& base() const noexcept
+      {
+        return m_it;
+      }
+
+      constexpr reference operator*() const
+      {
+        return Adaptor::apply(*m_it);
+      }
+
+      constexpr reference operator[](difference_type n) const
+      {
+        return Adaptor::apply(m_it[n]);
+      }
+
+      constexpr basic_iterator& operator++()
+      {
+        ++m_it;
+        return *this;
+      }
+
+      constexpr basic_iterator operator++(int)
+      {
+        basic_iterator it = *this;
+        ++m_it;
+        return it;
+      }
+
+      constexpr basic_iterator& operator--()
+      {
+        --m_it;
+        return *this;
+      }
+
+      constexpr basic_iterator operator--(int)
+      {
+        basic_iterator it = *this;
+        --m_it;
+        return it;
+      }
+
+      constexpr basic_iterator& operator+=(difference_type n)
+      {
+        m_it += n;
+        return *this;
+      }
+
+      constexpr basic_iterator& operator-=(difference_type n)
+      {
+        m_it -= n;
+        return *this;
+      }
+
+      friend constexpr basic_iterator operator+(basic_iterator it, difference_type n)
+      {
+        return it += n;
+      }
+
+      friend constexpr basic_iterator operator+(difference_type n, basic_iterator it)
+      {
+        return it += n;
+      }
+
+      friend constexpr basic_iterator operator-(basic_iterator it, difference_type n)
+      {
+        return it -= n;
+      }
+
+      friend constexpr difference_type
+      operator-(basic_iterator const& lhs, basic_iterator const& rhs)
+      {
+        return lhs.m_it - rhs.m_it;
+      }
+
+      friend constexpr bool
+      operator==(basic_iterator const& lhs, basic_iterator const& rhs)
+      {
+        return lhs.m_it == rhs.m_it;
+      }
+
+      friend constexpr bool
+      operator!=(basic_iterator const& lhs, basic_iterator const& rhs)
+      {
+        return lhs.m_it != rhs.m_it;
+      }
+
+      friend constexpr bool
+      operator<(basic_iterator const& lhs, basic_iterator const& rhs)
+      {
+        return lhs.m_it < rhs.m_it;
+      }
+
+      friend constexpr bool
+      operator>(basic_iterator const& lhs, basic_iterator const& rhs)
+      {
+        return lhs.m_it > rhs.m_it;
+      }
+
+      friend constexpr bool
+      operator<=(basic_iterator const& lhs, basic_iterator const& rhs)
+      {
+        return lhs.m_it <= rhs.m_it;
+      }
+
+      friend constexpr bool
+      operator>=(basic_iterator const& lhs, basic_iterator const& rhs)
+      {
+        return lhs.m_it >= rhs.m_it;
+      }
+
+    private:
+      base_iterator m_it = {};
+    };
+
+    // The end of a range whose end is not an iterator.
+    template <typename Base>
+    class basic_sentinel
+    {
+      using base_sentinel = decltype(std::end(std::declval<Base&>()));
+
+    public:
+      constexpr basic_sentinel() = default;
+
+      constexpr explicit basic_sentinel(base_sentinel end)
+      : m_end(std::move(end))
+      {
+      }
+
+      friend constexpr bool
+      operator==(basic_iterator<Base> const& it, basic_sentinel const& end)
+      {
+        return it.base() == end.m_end;
+      }
+
+      friend constexpr bool
+      operator==(basic_sentinel const& end, basic_iterator<Base> const& it)
+      {
+        return it.base() == end.m_end;
+      }
+
+      friend constexpr bool
+      operator!=(basic_iterator<Base> const& it, basic_sentinel const& end)
+      {
+        return !(it.base() == end.m_end);
+      }
+
+      friend constexpr bool
+      operator!=(basic_sentinel const& end, basic_iterator<Base> const& it)
+      {
+        return !(it.base() == end.m_end);
+      }
+
+    private:
+      base_sentinel m_end = {};
+    };
+
+    template <typename Base>
+    using basic_end = std::conditional_t<
+        std::is_same_v<
+            decltype(std::begin(std::declval<Base&>())),
+            decltype(std::end(std::declval<Base&>()))>,
+        basic_iterator<Base>,
+        basic_sentinel<Base>>;
+
+  public:
+    using iterator = basic_iterator<Range>;
+    using value_type = typename iterator::value_type;
+
+    constexpr reference_view() = default;
+
+    template <
+        typename R = Range,
+        std::enable_if_t<!detail::stores_range_by_value_v<R>, int> = 0>
+    constexpr explicit reference_view(Range& range) noexcept
+    : m_range(std::addressof(range))
+    {
+    }
+
+    template <
+        typename R = Range,
+        std::enable_if_t<detail::stores_range_by_value_v<R>, int> = 0>
+    constexpr explicit reference_view(Range range)
+    : m_range(std::move(range))
+    {
+    }
+
+    constexpr iterator begin()
+    {
+      return iterator(std::begin(get()));
+    }
+
+    template <
+        typename R = const_range,
+        typename = decltype(std::begin(std::declval<R&>()))>
+    constexpr basic_iterator<R> begin() const
+    {
+      return basic_iterator<R>(std::begin(get()));
+    }
+
+    constexpr basic_end<Range> end()
+    {
+      return basic_end<Range>(std::end(get()));
+    }
+
+    template <typename R = const_range, typename = decltype(std::end(std::declval<R&>()))>
+    constexpr basic_end<R> end() const
+    {
+      return basic_end<R>(std::end(get()));
+    }
+
+  private:
+    constexpr Range& get() noexcept
+    {
+      if constexpr (by_value)
+      {
+        return m_range;
+      }
+      else
+      {
+        return *m_range;
+      }
+    }
+
+    constexpr const_range& get() const noexcept
+    {
+      if constexpr (by_value)
+      {
+        return m_range;
+      }
+      else
+      {
+        return *m_range;
+      }
+    }
+
+    stored_range m_range = stored_range();
+  };
+
+  template <typename Range>
+  using retained_view = reference_view<Range, detail::to_retained>;
+
+  template <typename Range>
+  using optional_ref_view = reference_view<Range, detail::to_optional_ref>;
+
+  namespace detail
+  {
+    template <typename Adaptor>
+    struct reference_view_adaptor
+    {
+      template <typename Range>
+      using view_for = reference_view<reference_view_range_t<Range>, Adaptor>;
+
+      template <
+          typename Range,
+          std::enable_if_t<is_reference_viewable<Range>::value, int> = 0>
+      constexpr view_for<Range> operator()(Range&& range) const
+      {
+        return view_for<Range>(std::forward<Range>(range));
+      }
+
+      template <
+          typename Range,
+          std::enable_if_t<!is_reference_viewable<Range>::value, int> = 0>
+      void operator()(Range&&) const = delete;
+
+      // Friend templates cannot have default template arguments, so these are
+      // constrained by their return types.
+      template <typename Range>
+      friend constexpr auto
+      operator|(Range&& range, reference_view_adaptor const& adaptor)
+          -> decltype(adaptor(std::forward<Range>(range)))
+      {
+        return adaptor(std::forward<Range>(range));
+      }
+
+      template <typename Range>
+      friend auto operator|(Range&&, reference_view_adaptor const&)
+          -> std::enable_if_t<!is_reference_viewable<Range>::value> = delete;
+    };
+  } // namespace detail
+
+  namespace views
+  {
+    // `views::retained(range)` or `range | views::retained` is a view of
+    // `range` that yields a `retained` to each element.
+    inline constexpr detail::reference_view_adaptor<detail::to_retained> retained{};
+
+    // `views::optional_ref(range)` or `range | views::optional_ref` is a view
+    // of `range` that yields an `optional_ref` to each element, or to the
+    // object each element points to.
+    inline constexpr detail::reference_view_adaptor<detail::to_optional_ref>
+        optional_ref{};
+  } // namespace views
+
+} // namespace gsl
+
+#if defined(GSL_POINTERS_RANGES)
+// A view of a referenced range is borrowed, and a view of a stored view is
+// borrowed if that view is.
+template <typename Range, typename Adaptor>
+inline constexpr bool
+    std::ranges::enable_borrowed_range<gsl::reference_view<Range, Adaptor>> =
+        !gsl::detail::stores_range_by_value_v<Range>
+        || std::ranges::enable_borrowed_range<Range>;
+#endif
+
+#endif // GSL_REFERENCE_VIEW_HPP
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GSL_RELOCATABLE_HPP
+#define GSL_RELOCATABLE_HPP
+
+#include "relocatable_traits.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace gsl
+{
+  // Moves the object at `source` to the uninitialized storage at `dest` and ends
+  // the lifetime of the original.
+  template <typename T>
+  T* relocate_at(T* source, T* dest) noexcept(is_nothrow_relocatable_v<T>)
+  {
+    if constexpr (is_trivially_relocatable_v<T>)
+    {
+      std::memmove(static_cast<void*>(dest), static_cast<void const*>(source), sizeof(T));
+      return std::launder(dest);
+    }
+    else
+    {
+      T* const result = ::new (static_cast<void*>(dest)) T(std::move(*source));
+      std::destroy_at(source);
+      return result;
+    }
+  }
+
+  // Relocates the objects in `[first, last)` to the uninitialized storage
+  // starting at `dest` and returns the end of the destination range. The ranges
+  // may overlap if `dest` comes before `first`, as when erasing from the middle
+  // of a vector.
+  template <typename T>
+  T* uninitialized_relocate(T* first, T* last, T* dest) noexcept(
+      is_nothrow_relocatable_v<T>)
+  {
+    if constexpr (is_trivially_relocatable_v<T>)
+    {
+      auto const n = static_cast<std::size_t>(last - first);
+
+      if (n != 0)
+      {
+        std::memmove(
+            static_cast<void*>(dest), static_cast<void const*>(first), n * sizeof(T));
+      }
+
+      return dest + n;
+    }
+    else
+    {
+      for (; first != last; ++first, ++dest)
+      {
+        relocate_at(first, dest);
+      }
+
+      return dest;
+    }
+  }
+
+  // Relocates the objects in `[first, last)` to the uninitialized storage
+  // ending at `dest_last` and returns the start of the destination range. The
+  // ranges may overlap if `dest_last` comes after `last`, as when inserting into
+  // the middle of a vector.
+  template <typename T>
+  T* uninitialized_relocate_backward(T* first, T* last, T* dest_last) noexcept(
+      is_nothrow_relocatable_v<T>)
+  {
+    if constexpr (is_trivially_relocatable_v<T>)
+    {
+      auto const n = static_cast<std::size_t>(last - first);
+
+      if (n != 0)
+      {
+        std::memmove(
+            static_cast<void*>(dest_last - n),
+            static_cast<void const*>(first),
+            n * sizeof(T));
+      }
+
+      return dest_last - n;
+    }
+    else
+    {
+      while (last != first)
+      {
+        relocate_at(--last, --dest_last);
+      }
+
+      return dest_last;
+    }
+  }
+} // namespace gsl
+
+#endif // GSL_RELOCATABLE_HPP
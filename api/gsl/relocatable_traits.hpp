@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GSL_RELOCATABLE_TRAITS_HPP
+#define GSL_RELOCATABLE_TRAITS_HPP
+
+#include <type_traits>
+
+// Marks a class as trivially relocatable on compilers that implement P1144.
+#if defined(__has_cpp_attribute)
+#if __has_cpp_attribute(trivially_relocatable)
+#define GSL_TRIVIALLY_RELOCATABLE [[trivially_relocatable]]
+#endif
+#endif
+
+#if !defined(GSL_TRIVIALLY_RELOCATABLE)
+#define GSL_TRIVIALLY_RELOCATABLE
+#endif
+
+namespace gsl
+{
+  namespace detail
+  {
+    template <typename T>
+    constexpr bool is_builtin_trivially_relocatable()
+    {
+#if defined(__has_builtin)
+#if __has_builtin(__is_trivially_relocatable)
+      return __is_trivially_relocatable(T);
+#endif
+#endif
+      return false;
+    }
+  } // namespace detail
+
+  // Whether moving a `T` to a new address and destroying the original is
+  // equivalent to copying its bytes. Specialize for types that are trivially
+  // relocatable but neither trivially movable nor trivially destructible.
+  template <typename T>
+  struct is_trivially_relocatable
+  : std::bool_constant<
+        std::is_trivially_copyable_v<T>
+        || (std::is_trivially_move_constructible_v<T>
+            && std::is_trivially_destructible_v<T>)
+        || detail::is_builtin_trivially_relocatable<T>()>
+  {
+  };
+
+  template <typename T>
+  constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+  template <typename T>
+  constexpr bool is_nothrow_relocatable_v =
+      is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T>;
+} // namespace gsl
+
+#endif // GSL_RELOCATABLE_TRAITS_HPP
@@ -23,128 +23,65 @@
 #ifndef GSL_RETAINED_HPP
 #define GSL_RETAINED_HPP
 
+#include "contract.hpp"
+#include "retained_core.hpp"
+#include "retained_hash.hpp"
+
 #include <cstddef>
-#include <functional>
-#include <memory>
-#include <type_traits>
-#include <utility>
+
+#if __has_include(<span>)
+#include <span>
+#endif
 
 namespace gsl
 {
+  // Views the `n` pointers starting at `p` as an array of `retained<T>` without
+  // copying. None of the pointers may be null, which is checked in hardened
+  // builds.
   template <typename T>
-  class retained
+  retained<T> const* as_retained(T* const* p, std::size_t n)
   {
-    template <typename>
-    friend class retained;
-
-  public:
-    using element_type = T;
-
-    constexpr explicit retained(T& t) noexcept
-    : m_ptr(std::addressof(t))
-    {
-    }
-
-    constexpr explicit retained(T&&) noexcept = delete;
-
-    constexpr explicit retained(retained const&) noexcept = delete;
-    constexpr explicit retained(retained&&) noexcept = default;
-
-    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
-    constexpr retained(retained<U>&& other) noexcept
-    : m_ptr(other.m_ptr)
-    {
-    }
-
-    constexpr retained& operator=(retained const&) noexcept = delete;
-    constexpr retained& operator=(retained&&) noexcept = default;
-
-    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
-    retained& operator=(retained<U>&& other) noexcept
-    {
-      m_ptr = other.m_ptr;
-      return *this;
-    }
-
-    constexpr T& operator*() noexcept
-    {
-      return *m_ptr;
-    }
-
-    constexpr T const& operator*() const noexcept
-    {
-      return *m_ptr;
-    }
-
-    constexpr T* operator->() noexcept
+#if defined(GSL_POINTERS_HARDENED)
+    for (std::size_t i = 0; i != n; ++i)
     {
-      return m_ptr;
+      detail::expect(p[i] != nullptr, "null pointer viewed as a retained");
     }
+#else
+    static_cast<void>(n);
+#endif
 
-    constexpr operator T const*() const noexcept
-    {
-      return m_ptr;
-    }
-
-    void swap(retained& other) noexcept
-    {
-      using std::swap;
-      swap(m_ptr, other.m_ptr);
-    }
-
-  private:
-    T* m_ptr;
-  };
+    return as_retained_unchecked(p);
+  }
 
-  template <typename T>
-  constexpr retained<T> make_retained(T& t) noexcept
+#if defined(__cpp_lib_span)
+  template <typename T, std::size_t Extent>
+  std::span<T const* const, Extent> as_pointers(
+      std::span<retained<T> const, Extent> s) noexcept
   {
-    return retained<T>(t);
+    return std::span<T const* const, Extent>(as_pointers(s.data()), s.size());
   }
 
-  template <typename T>
-  retained<T> make_retained(T&&) = delete;
-
-  template <typename T>
-  void swap(retained<T>& lhs, retained<T>& rhs) noexcept
+  template <typename T, std::size_t Extent>
+  std::span<T* const, Extent> as_pointers(std::span<retained<T>, Extent> s) noexcept
   {
-    lhs.swap(rhs);
+    return std::span<T* const, Extent>(as_pointers(s.data()), s.size());
   }
 
-  template <typename T1, typename T2>
-  constexpr bool operator==(retained<T1> const& lhs, retained<T2> const& rhs) noexcept
+  template <typename T, std::size_t Extent>
+  std::span<retained<T> const, Extent> as_retained(std::span<T* const, Extent> s)
   {
-    return &*lhs == &*rhs;
+    auto const p = as_retained(s.data(), s.size());
+    return std::span<retained<T> const, Extent>(p, s.size());
   }
 
-  template <typename T1, typename T2>
-  constexpr bool operator!=(retained<T1> const& lhs, retained<T2> const& rhs) noexcept
+  template <typename T, std::size_t Extent>
+  std::span<retained<T> const, Extent> as_retained(std::span<T*, Extent> s)
   {
-    return !(lhs == rhs);
+    auto const p = as_retained(s.data(), s.size());
+    return std::span<retained<T> const, Extent>(p, s.size());
   }
+#endif
 
 } // namespace gsl
 
-namespace std
-{
-  template <typename T>
-  struct less<gsl::retained<T>>
-  {
-    constexpr bool operator()(gsl::retained<T> const& lhs, gsl::retained<T> const& rhs)
-        const noexcept
-    {
-      return less<T const*>()(&*lhs, &*rhs);
-    }
-  };
-
-  template <typename T>
-  struct hash<gsl::retained<T>>
-  {
-    constexpr std::size_t operator()(gsl::retained<T> const& r) const noexcept
-    {
-      return hash<T const*>()(&*r);
-    }
-  };
-} // namespace std
-
 #endif // GSL_RETAINED_HPP
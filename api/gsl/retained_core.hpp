@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GSL_RETAINED_CORE_HPP
+#define GSL_RETAINED_CORE_HPP
+
+#include "instrument.hpp"
+#include "relocatable_traits.hpp"
+#include "utility.hpp"
+
+#include <type_traits>
+
+namespace gsl
+{
+  template <typename T>
+  class optional_retained;
+
+  template <typename T>
+  class GSL_TRIVIALLY_RELOCATABLE retained
+  {
+    template <typename>
+    friend class retained;
+
+    template <typename>
+    friend class optional_retained;
+
+  public:
+    using element_type = T;
+
+    constexpr explicit retained(T& t) noexcept
+    : m_ptr(detail::addressof(t))
+    {
+      // Arrays of `retained<T>` can be viewed as arrays of `T*`; see `as_pointers`.
+      static_assert(std::is_standard_layout_v<retained>);
+      static_assert(sizeof(retained) == sizeof(T*));
+      static_assert(alignof(retained) == alignof(T*));
+    }
+
+    constexpr explicit retained(T&&) noexcept = delete;
+
+    constexpr explicit retained(retained const&) noexcept = delete;
+    constexpr explicit retained(retained&&) noexcept = default;
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    constexpr retained(retained<U>&& other) noexcept
+    : m_ptr(other.m_ptr)
+    {
+    }
+
+    constexpr retained& operator=(retained const&) noexcept = delete;
+    constexpr retained& operator=(retained&&) noexcept = default;
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    constexpr retained& operator=(retained<U>&& other) noexcept
+    {
+      m_ptr = other.m_ptr;
+      return *this;
+    }
+
+    constexpr T& operator*() noexcept
+    {
+      GSL_POINTERS_COUNT(dereference);
+      return *m_ptr;
+    }
+
+    constexpr T const& operator*() const noexcept
+    {
+      GSL_POINTERS_COUNT(dereference);
+      return *m_ptr;
+    }
+
+    constexpr T* operator->() noexcept
+    {
+      GSL_POINTERS_COUNT(dereference);
+      return m_ptr;
+    }
+
+    constexpr operator T const*() const noexcept
+    {
+      return m_ptr;
+    }
+
+    // `std::swap` is not `constexpr` until C++20.
+    constexpr void swap(retained& other) noexcept
+    {
+      T* const ptr = m_ptr;
+      m_ptr = other.m_ptr;
+      other.m_ptr = ptr;
+    }
+
+  private:
+    T* m_ptr;
+  };
+
+  // Relocating a `retained<T>` only copies the pointer it holds.
+  template <typename T>
+  struct is_trivially_relocatable<retained<T>> : std::true_type
+  {
+  };
+
+  template <typename T>
+  constexpr retained<T> make_retained(T& t) noexcept
+  {
+    return retained<T>(t);
+  }
+
+  template <typename T>
+  retained<T> make_retained(T&&) = delete;
+
+  template <typename T>
+  constexpr void swap(retained<T>& lhs, retained<T>& rhs) noexcept
+  {
+    lhs.swap(rhs);
+  }
+
+  // Views an array of `retained<T>` as an array of `T*` without copying, for
+  // passing to interfaces that take `T* const*`.
+  template <typename T>
+  T const* const* as_pointers(retained<T> const* p) noexcept
+  {
+    return reinterpret_cast<T const* const*>(p);
+  }
+
+  template <typename T>
+  T* const* as_pointers(retained<T>* p) noexcept
+  {
+    return reinterpret_cast<T* const*>(p);
+  }
+
+  // Views an array of `T*` as an array of `retained<T>` without copying. None
+  // of the pointers may be null, which is not checked, even in hardened builds;
+  // `as_retained` in `retained.hpp` checks each pointer in hardened builds.
+  template <typename T>
+  retained<T> const* as_retained_unchecked(T* const* p) noexcept
+  {
+    return reinterpret_cast<retained<T> const*>(p);
+  }
+
+  template <typename T1, typename T2>
+  constexpr bool operator==(retained<T1> const& lhs, retained<T2> const& rhs) noexcept
+  {
+    return static_cast<T1 const*>(lhs) == static_cast<T2 const*>(rhs);
+  }
+
+  template <typename T1, typename T2>
+  constexpr bool operator!=(retained<T1> const& lhs, retained<T2> const& rhs) noexcept
+  {
+    return !(lhs == rhs);
+  }
+
+} // namespace gsl
+
+#endif // GSL_RETAINED_CORE_HPP
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GSL_RETAINED_HASH_HPP
+#define GSL_RETAINED_HASH_HPP
+
+#include "retained_core.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+namespace gsl
+{
+  namespace detail
+  {
+    constexpr std::uintptr_t mix_address_bits(std::uintptr_t x) noexcept
+    {
+      if constexpr (sizeof(std::uintptr_t) >= 8)
+      {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdu;
+        x ^= x >> 33;
+      }
+      else
+      {
+        x ^= x >> 16;
+        x *= 0x45d9f3bu;
+        x ^= x >> 16;
+      }
+
+      return x;
+    }
+
+    // Maps each of the key types accepted by the transparent comparators and
+    // hashers of `retained<T>` to the address of the referenced object. Only
+    // exact matches are accepted, because a key that converts to `T` would
+    // bind to a temporary whose address matches nothing. For the same reason,
+    // rvalues of `T` are rejected.
+    template <typename T>
+    struct retained_key
+    {
+      using U = std::remove_const_t<T>;
+
+      template <typename V>
+      static constexpr bool is_referenceable_v =
+          std::is_convertible_v<std::remove_const_t<V>*, U*>;
+
+      template <typename V, typename = std::enable_if_t<is_referenceable_v<V>>>
+      static constexpr T const* address(V* p) noexcept
+      {
+        return p;
+      }
+
+      template <typename K, typename = std::enable_if_t<std::is_same_v<K, U>>>
+      static constexpr T const* address(K const& t) noexcept
+      {
+        return detail::addressof(t);
+      }
+
+      template <typename K, typename = std::enable_if_t<std::is_same_v<K, U>>>
+      static void address(K const&&) = delete;
+
+      template <typename V, typename = std::enable_if_t<is_referenceable_v<V>>>
+      static constexpr T const* address(retained<V> const& r) noexcept
+      {
+        return static_cast<V const*>(r);
+      }
+    };
+
+    // `K` is deduced from a forwarding reference, so it is a non-reference type
+    // for rvalue keys.
+    template <typename T, typename K>
+    using retained_key_t = decltype(retained_key<T>::address(std::declval<K>()));
+
+    template <typename T>
+    std::size_t hash_address(T const* p) noexcept
+    {
+      // The low bits of an address are always zero for over-aligned types.
+      return static_cast<std::size_t>(
+          mix_address_bits(reinterpret_cast<std::uintptr_t>(p) / alignof(T)));
+    }
+  } // namespace detail
+
+  // A hash function for `retained<T>` that mixes the bits of the address so
+  // that it can be used with power-of-two sized open addressing hash tables,
+  // which `std::hash<retained<T>>`, an identity function on most standard
+  // library implementations, is poorly suited for.
+  //
+  // Like the transparent `std::less`, `std::equal_to` and `std::hash`
+  // specializations for `retained<T>`, it rejects temporary `T` keys when called
+  // directly. Container lookup functions such as `std::set::find` take their
+  // key by reference and pass it on as an lvalue, so temporaries passed to them
+  // are accepted and compare unequal to every element.
+  template <typename T>
+  struct retained_hash
+  {
+    using is_transparent = void;
+
+    template <typename K, typename = detail::retained_key_t<T, K>>
+    constexpr std::size_t operator()(K&& k) const noexcept
+    {
+      return detail::hash_address(detail::retained_key<T>::address(k));
+    }
+  };
+
+} // namespace gsl
+
+namespace std
+{
+  template <typename T>
+  struct less<gsl::retained<T>>
+  {
+    using is_transparent = void;
+
+    template <
+        typename K1,
+        typename K2,
+        typename = gsl::detail::retained_key_t<T, K1>,
+        typename = gsl::detail::retained_key_t<T, K2>>
+    constexpr bool operator()(K1&& lhs, K2&& rhs) const noexcept
+    {
+      using key = gsl::detail::retained_key<T>;
+      return less<T const*>()(key::address(lhs), key::address(rhs));
+    }
+  };
+
+  template <typename T>
+  struct equal_to<gsl::retained<T>>
+  {
+    using is_transparent = void;
+
+    template <
+        typename K1,
+        typename K2,
+        typename = gsl::detail::retained_key_t<T, K1>,
+        typename = gsl::detail::retained_key_t<T, K2>>
+    constexpr bool operator()(K1&& lhs, K2&& rhs) const noexcept
+    {
+      using key = gsl::detail::retained_key<T>;
+      return key::address(lhs) == key::address(rhs);
+    }
+  };
+
+  template <typename T>
+  struct hash<gsl::retained<T>>
+  {
+    using is_transparent = void;
+
+    template <typename K, typename = gsl::detail::retained_key_t<T, K>>
+    constexpr std::size_t operator()(K&& k) const noexcept
+    {
+      return hash<T const*>()(gsl::detail::retained_key<T>::address(k));
+    }
+  };
+} // namespace std
+
+#endif // GSL_RETAINED_HASH_HPP
@@ -0,0 +1,434 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GSL_RETAINED_OFFSET_HPP
+#define GSL_RETAINED_OFFSET_HPP
+
+#include "contract.hpp"
+#include "retained.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace gsl
+{
+  namespace detail
+  {
+    // Stores the address of an object as a signed byte offset from its own
+    // address, so that the representation is independent of where the
+    // containing memory is mapped.
+    //
+    // An offset of one is reserved to represent "no object". No object can
+    // begin one byte past the start of the offset itself unless it overlaps
+    // the offset, which is at least two bytes in size.
+    template <typename OffsetT>
+    class self_relative_offset
+    {
+      static_assert(
+          std::is_integral_v<OffsetT> && std::is_signed_v<OffsetT>,
+          "the offset type must be a signed integral type");
+      static_assert(sizeof(OffsetT) >= 2, "the offset type must be at least two bytes");
+
+    protected:
+      static constexpr OffsetT null_offset = 1;
+
+      static constexpr bool is_nothrow = sizeof(OffsetT) >= sizeof(std::intptr_t);
+
+      self_relative_offset() noexcept
+      : m_offset(null_offset)
+      {
+      }
+
+      bool is_null() const noexcept
+      {
+        return m_offset == null_offset;
+      }
+
+      void* address() const noexcept
+      {
+        return reinterpret_cast<void*>(base() + static_cast<std::intptr_t>(m_offset));
+      }
+
+      void set_null() noexcept
+      {
+        m_offset = null_offset;
+      }
+
+      void set_address(void const* p) noexcept(is_nothrow)
+      {
+        std::intptr_t const offset = reinterpret_cast<std::intptr_t>(p) - base();
+
+        if constexpr (!is_nothrow)
+        {
+          detail::check(
+              offset >= std::numeric_limits<OffsetT>::min()
+                  && offset <= std::numeric_limits<OffsetT>::max(),
+              "object is out of range of the offset type");
+        }
+
+        m_offset = static_cast<OffsetT>(offset);
+      }
+
+      OffsetT offset() const noexcept
+      {
+        return m_offset;
+      }
+
+    private:
+      std::intptr_t base() const noexcept
+      {
+        return reinterpret_cast<std::intptr_t>(this);
+      }
+
+      OffsetT m_offset;
+    };
+  } // namespace detail
+
+  // A `retained<T>` that stores the referenced object's address relative to
+  // its own, using an `OffsetT`. It is position-independent, so structures
+  // wired with it remain valid when copied byte-for-byte or mapped at a
+  // different address, provided the referenced objects move with them.
+  //
+  // It is a contract violation, checked in all builds, for the referenced
+  // object to be too far away to be represented by `OffsetT`. Moving recomputes
+  // the offset, so `retained_offset` is not trivially movable. Moves are
+  // `noexcept`, so a violation handler that throws terminates the program if
+  // the object is moved out of range.
+  template <typename T, typename OffsetT = std::int32_t>
+  class retained_offset : detail::self_relative_offset<OffsetT>
+  {
+    using base = detail::self_relative_offset<OffsetT>;
+
+  public:
+    using element_type = T;
+    using offset_type = OffsetT;
+
+    explicit retained_offset(T& t) noexcept(base::is_nothrow)
+    {
+      base::set_address(std::addressof(t));
+    }
+
+    explicit retained_offset(T&&) noexcept = delete;
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    explicit retained_offset(retained<U>&& r) noexcept(base::is_nothrow)
+    {
+      base::set_address(static_cast<T*>(std::addressof(*r)));
+    }
+
+    explicit retained_offset(retained_offset const&) noexcept = delete;
+
+    retained_offset(retained_offset&& other) noexcept
+    {
+      base::set_address(other.operator->());
+    }
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    retained_offset(retained_offset<U, OffsetT>&& other) noexcept
+    {
+      base::set_address(static_cast<T*>(other.operator->()));
+    }
+
+    retained_offset& operator=(retained_offset const&) noexcept = delete;
+
+    retained_offset& operator=(retained_offset&& other) noexcept
+    {
+      base::set_address(other.operator->());
+      return *this;
+    }
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    retained_offset& operator=(retained_offset<U, OffsetT>&& other) noexcept
+    {
+      base::set_address(static_cast<T*>(other.operator->()));
+      return *this;
+    }
+
+    T& operator*() noexcept
+    {
+      return *operator->();
+    }
+
+    T const& operator*() const noexcept
+    {
+      return *static_cast<T const*>(*this);
+    }
+
+    T* operator->() noexcept
+    {
+      return static_cast<T*>(base::address());
+    }
+
+    operator T const*() const noexcept
+    {
+      return static_cast<T const*>(base::address());
+    }
+
+    // Returns a `retained<T>` referencing the same object.
+    retained<T> get() noexcept
+    {
+      return retained<T>(**this);
+    }
+
+    retained<T const> get() const noexcept
+    {
+      return retained<T const>(**this);
+    }
+
+    OffsetT offset() const noexcept
+    {
+      return base::offset();
+    }
+
+    void swap(retained_offset& other) noexcept
+    {
+      T* const p = other.operator->();
+      other.set_address(operator->());
+      base::set_address(p);
+    }
+  };
+
+  template <typename OffsetT = std::int32_t, typename T>
+  retained_offset<T, OffsetT>
+  make_retained_offset(T& t) noexcept(sizeof(OffsetT) >= sizeof(std::intptr_t))
+  {
+    return retained_offset<T, OffsetT>(t);
+  }
+
+  template <typename OffsetT = std::int32_t, typename T>
+  retained_offset<T, OffsetT> make_retained_offset(T&&) = delete;
+
+  template <typename T, typename OffsetT>
+  void swap(retained_offset<T, OffsetT>& lhs, retained_offset<T, OffsetT>& rhs) noexcept
+  {
+    lhs.swap(rhs);
+  }
+
+  template <typename T1, typename T2, typename OffsetT>
+  bool operator==(
+      retained_offset<T1, OffsetT> const& lhs,
+      retained_offset<T2, OffsetT> const& rhs) noexcept
+  {
+    return &*lhs == &*rhs;
+  }
+
+  template <typename T1, typename T2, typename OffsetT>
+  bool operator!=(
+      retained_offset<T1, OffsetT> const& lhs,
+      retained_offset<T2, OffsetT> const& rhs) noexcept
+  {
+    return !(lhs == rhs);
+  }
+
+  // A position-independent `optional_retained<T>` that uses the reserved
+  // offset of `retained_offset` to represent its disengaged state, so that it
+  // is no larger than `OffsetT`.
+  template <typename T, typename OffsetT = std::int32_t>
+  class optional_retained_offset : detail::self_relative_offset<OffsetT>
+  {
+    using base = detail::self_relative_offset<OffsetT>;
+
+  public:
+    using element_type = T;
+    using offset_type = OffsetT;
+
+    optional_retained_offset() noexcept = default;
+
+    optional_retained_offset(std::nullopt_t) noexcept
+    {
+    }
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    optional_retained_offset(retained<U>&& r) noexcept(base::is_nothrow)
+    {
+      base::set_address(static_cast<T*>(std::addressof(*r)));
+    }
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    optional_retained_offset(retained_offset<U, OffsetT>&& r) noexcept
+    {
+      base::set_address(static_cast<T*>(r.operator->()));
+    }
+
+    explicit optional_retained_offset(optional_retained_offset const&) noexcept = delete;
+
+    optional_retained_offset(optional_retained_offset&& other) noexcept
+    {
+      assign(other);
+    }
+
+    optional_retained_offset&
+    operator=(optional_retained_offset const&) noexcept = delete;
+
+    optional_retained_offset&
+    operator=(optional_retained_offset&& other) noexcept
+    {
+      assign(other);
+      return *this;
+    }
+
+    optional_retained_offset& operator=(std::nullopt_t) noexcept
+    {
+      base::set_null();
+      return *this;
+    }
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    optional_retained_offset& operator=(retained<U>&& r) noexcept(base::is_nothrow)
+    {
+      base::set_address(static_cast<T*>(std::addressof(*r)));
+      return *this;
+    }
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    optional_retained_offset&
+    operator=(retained_offset<U, OffsetT>&& r) noexcept
+    {
+      base::set_address(static_cast<T*>(r.operator->()));
+      return *this;
+    }
+
+    bool has_value() const noexcept
+    {
+      return !base::is_null();
+    }
+
+    explicit operator bool() const noexcept
+    {
+      return has_value();
+    }
+
+    T& operator*() noexcept
+    {
+      return *operator->();
+    }
+
+    T const& operator*() const noexcept
+    {
+      return *operator->();
+    }
+
+    T* operator->() noexcept
+    {
+      detail::expect_dereferenceable(has_value());
+      return static_cast<T*>(base::address());
+    }
+
+    T const* operator->() const noexcept
+    {
+      detail::expect_dereferenceable(has_value());
+      return static_cast<T const*>(base::address());
+    }
+
+    T& value()
+    {
+      detail::expect_engaged(has_value());
+
+      return **this;
+    }
+
+    T const& value() const
+    {
+      detail::expect_engaged(has_value());
+
+      return **this;
+    }
+
+    void reset() noexcept
+    {
+      base::set_null();
+    }
+
+    OffsetT offset() const noexcept
+    {
+      return base::offset();
+    }
+
+  private:
+    void assign(optional_retained_offset& other) noexcept
+    {
+      if (other)
+      {
+        base::set_address(other.operator->());
+      }
+      else
+      {
+        base::set_null();
+      }
+    }
+  };
+
+  template <typename T1, typename T2, typename OffsetT>
+  bool operator==(
+      optional_retained_offset<T1, OffsetT> const& lhs,
+      optional_retained_offset<T2, OffsetT> const& rhs) noexcept
+  {
+    return (bool(lhs) != bool(rhs)) ? false
+        : (bool(lhs) == false)      ? true
+                                    : &*lhs == &*rhs;
+  }
+
+  template <typename T1, typename T2, typename OffsetT>
+  bool operator!=(
+      optional_retained_offset<T1, OffsetT> const& lhs,
+      optional_retained_offset<T2, OffsetT> const& rhs) noexcept
+  {
+    return !(lhs == rhs);
+  }
+
+  template <typename T, typename OffsetT>
+  bool operator==(
+      optional_retained_offset<T, OffsetT> const& opt, std::nullopt_t) noexcept
+  {
+    return !opt;
+  }
+
+  template <typename T, typename OffsetT>
+  bool operator==(
+      std::nullopt_t, optional_retained_offset<T, OffsetT> const& opt) noexcept
+  {
+    return !opt;
+  }
+
+  template <typename T, typename OffsetT>
+  bool operator!=(
+      optional_retained_offset<T, OffsetT> const& opt, std::nullopt_t) noexcept
+  {
+    return bool(opt);
+  }
+
+  template <typename T, typename OffsetT>
+  bool operator!=(
+      std::nullopt_t, optional_retained_offset<T, OffsetT> const& opt) noexcept
+  {
+    return bool(opt);
+  }
+
+} // namespace gsl
+
+#endif // GSL_RETAINED_OFFSET_HPP
@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GSL_RETAINED_RESTRICT_HPP
+#define GSL_RETAINED_RESTRICT_HPP
+
+#include "contract.hpp"
+#include "relocatable.hpp"
+#include "retained.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define GSL_POINTERS_RESTRICT __restrict__
+#elif defined(_MSC_VER)
+#define GSL_POINTERS_RESTRICT __restrict
+#else
+#define GSL_POINTERS_RESTRICT
+#endif
+
+// Whether `restrict_scope` checks for overlapping references.
+#if !defined(GSL_POINTERS_RESTRICT_CHECKS)
+#if defined(NDEBUG)
+#define GSL_POINTERS_RESTRICT_CHECKS 0
+#else
+#define GSL_POINTERS_RESTRICT_CHECKS 1
+#endif
+#endif
+
+namespace gsl
+{
+  // A `retained<T>` that promises that, while it exists, the referenced object
+  // is not accessed other than through it, in the sense of `restrict`.
+  //
+  // The object is held through a `pointer`. GCC applies `restrict` to the
+  // pointer members of parameters passed by value, so kernels can take
+  // `retained_restrict`s by value. Other compilers only make use of `restrict`
+  // on pointer parameters, so portable kernels take `pointer` or
+  // `const_pointer` parameters and are passed the result of `get()`. The
+  // qualifier of a returned pointer is discarded, so `get()` returns `T*`.
+  template <typename T>
+  class GSL_TRIVIALLY_RELOCATABLE retained_restrict
+  {
+  public:
+    using element_type = T;
+    using pointer = T* GSL_POINTERS_RESTRICT;
+    using const_pointer = T const* GSL_POINTERS_RESTRICT;
+
+    constexpr explicit retained_restrict(T& t) noexcept
+    : m_ptr(std::addressof(t))
+    {
+    }
+
+    constexpr explicit retained_restrict(T&&) noexcept = delete;
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    constexpr explicit retained_restrict(retained<U>&& r) noexcept
+    : m_ptr(&*r)
+    {
+    }
+
+    constexpr retained_restrict(retained_restrict const&) noexcept = delete;
+    constexpr retained_restrict(retained_restrict&&) noexcept = default;
+
+    constexpr retained_restrict& operator=(retained_restrict const&) noexcept = delete;
+    constexpr retained_restrict& operator=(retained_restrict&&) noexcept = default;
+
+    constexpr T* get() noexcept
+    {
+      return m_ptr;
+    }
+
+    constexpr T const* get() const noexcept
+    {
+      return m_ptr;
+    }
+
+    constexpr T& operator*() noexcept
+    {
+      return *m_ptr;
+    }
+
+    constexpr T const& operator*() const noexcept
+    {
+      return *m_ptr;
+    }
+
+    constexpr T* operator->() noexcept
+    {
+      return m_ptr;
+    }
+
+    constexpr T const* operator->() const noexcept
+    {
+      return m_ptr;
+    }
+
+    constexpr operator T const*() const noexcept
+    {
+      return m_ptr;
+    }
+
+    void swap(retained_restrict& other) noexcept
+    {
+      using std::swap;
+      swap(m_ptr, other.m_ptr);
+    }
+
+  private:
+    pointer m_ptr;
+  };
+
+  template <typename T>
+  struct is_trivially_relocatable<retained_restrict<T>> : std::true_type
+  {
+  };
+
+  template <typename T>
+  constexpr retained_restrict<T> make_retained_restrict(T& t) noexcept
+  {
+    return retained_restrict<T>(t);
+  }
+
+  template <typename T>
+  retained_restrict<T> make_retained_restrict(T&&) = delete;
+
+  template <typename T>
+  void swap(retained_restrict<T>& lhs, retained_restrict<T>& rhs) noexcept
+  {
+    lhs.swap(rhs);
+  }
+
+  template <typename T1, typename T2>
+  constexpr bool operator==(
+      retained_restrict<T1> const& lhs, retained_restrict<T2> const& rhs) noexcept
+  {
+    return static_cast<T1 const*>(lhs) == static_cast<T2 const*>(rhs);
+  }
+
+  template <typename T1, typename T2>
+  constexpr bool operator!=(
+      retained_restrict<T1> const& lhs, retained_restrict<T2> const& rhs) noexcept
+  {
+    return !(lhs == rhs);
+  }
+
+  // Checks that the `retained_restrict`s registered with it do not overlap,
+  // unless none of them can be written through, and reports a contract
+  // violation otherwise. The checks are disabled when `NDEBUG` is defined,
+  // unless `GSL_POINTERS_RESTRICT_CHECKS` is defined to 1. As with `assert`,
+  // only the checking changes with the setting: the layout of the class is
+  // the same either way, and without checks no ranges are stored.
+  class restrict_scope
+  {
+  public:
+    restrict_scope() noexcept = default;
+
+    template <typename... Ts>
+    explicit restrict_scope(retained_restrict<Ts> const&... rs)
+    {
+      (add(rs), ...);
+    }
+
+    restrict_scope(restrict_scope const&) = delete;
+    restrict_scope& operator=(restrict_scope const&) = delete;
+
+    // Registers the `count` contiguous objects starting at the one referenced by
+    // `r`.
+    template <typename T>
+    restrict_scope& add(retained_restrict<T> const& r, std::size_t count = 1)
+    {
+      if constexpr (GSL_POINTERS_RESTRICT_CHECKS)
+      {
+        auto const first = reinterpret_cast<std::uintptr_t>(r.get());
+        range const added = {first, first + count * sizeof(T), !std::is_const_v<T>};
+
+        for (auto const& other : m_ranges)
+        {
+          bool const overlaps = added.first < other.last && other.first < added.last;
+
+          if (overlaps && (added.writable || other.writable))
+          {
+            detail::contract_violation("overlapping restrict references");
+          }
+        }
+
+        m_ranges.push_back(added);
+      }
+      else
+      {
+        static_cast<void>(r);
+        static_cast<void>(count);
+      }
+
+      return *this;
+    }
+
+  private:
+    struct range
+    {
+      std::uintptr_t first;
+      std::uintptr_t last;
+      bool writable;
+    };
+
+    std::vector<range> m_ranges;
+  };
+} // namespace gsl
+
+#endif // GSL_RETAINED_RESTRICT_HPP
@@ -0,0 +1,372 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GSL_RETAINED_SPAN_HPP
+#define GSL_RETAINED_SPAN_HPP
+
+#include "contract.hpp"
+#include "relocatable_traits.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#if __has_include(<span>)
+#include <span>
+#endif
+
+namespace gsl
+{
+  template <typename T>
+  class retained_span;
+
+  namespace detail
+  {
+    // Only qualification conversions are allowed between element types, as with
+    // `std::span`.
+    template <typename U, typename T>
+    inline constexpr bool is_element_convertible_v =
+        std::is_convertible_v<U (*)[], T (*)[]>;
+
+    template <typename C>
+    using container_element_t =
+        std::remove_pointer_t<decltype(std::data(std::declval<C&>()))>;
+
+    template <typename T>
+    struct is_retained_span : std::false_type
+    {
+    };
+
+    template <typename T>
+    struct is_retained_span<retained_span<T>> : std::true_type
+    {
+    };
+
+    // Whether the elements of a contiguous container `C` can be viewed as `T`s.
+    // Other `retained_span`s are excluded so that they cannot be copied.
+    template <typename C, typename T, typename = void>
+    struct is_compatible_container : std::false_type
+    {
+    };
+
+    template <typename C, typename T>
+    struct is_compatible_container<
+        C,
+        T,
+        std::void_t<container_element_t<C>, decltype(std::size(std::declval<C&>()))>>
+    : std::bool_constant<
+          !is_retained_span<std::remove_cv_t<std::remove_reference_t<C>>>::value
+          && is_element_convertible_v<container_element_t<C>, T>>
+    {
+    };
+
+    template <typename C, typename T>
+    inline constexpr bool is_compatible_container_v =
+        is_compatible_container<C, T>::value;
+  } // namespace detail
+
+  // A non-owning view of a contiguous sequence of `T`s that follows the rules of
+  // `retained<T>`: it must be constructed explicitly, cannot bind to temporaries,
+  // is move-only, and only gives `T const` access through a const object.
+  template <typename T>
+  class GSL_TRIVIALLY_RELOCATABLE retained_span
+  {
+    template <typename>
+    friend class retained_span;
+
+  public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using const_pointer = T const*;
+    using reference = T&;
+    using const_reference = T const&;
+    using iterator = T*;
+    using const_iterator = T const*;
+
+    // The caller guarantees that `[data, data + size)` is a valid range.
+    constexpr explicit retained_span(T* data, size_type size) noexcept
+    : m_data(data)
+    , m_size(size)
+    {
+      static_assert(sizeof(retained_span) == sizeof(T*) + sizeof(size_type));
+    }
+
+    template <
+        typename C,
+        typename = std::enable_if_t<detail::is_compatible_container_v<C, T>>>
+    constexpr explicit retained_span(C& c) noexcept
+    : retained_span(std::data(c), std::size(c))
+    {
+    }
+
+    template <
+        typename C,
+        typename = std::enable_if_t<
+            !std::is_lvalue_reference_v<C> && detail::is_compatible_container_v<C, T>>>
+    constexpr explicit retained_span(C&&) noexcept = delete;
+
+    constexpr explicit retained_span(retained_span const&) noexcept = delete;
+    constexpr explicit retained_span(retained_span&&) noexcept = default;
+
+    template <
+        typename U,
+        typename = std::enable_if_t<detail::is_element_convertible_v<U, T>>>
+    constexpr retained_span(retained_span<U>&& other) noexcept
+    : m_data(other.m_data)
+    , m_size(other.m_size)
+    {
+    }
+
+    constexpr retained_span& operator=(retained_span const&) noexcept = delete;
+    constexpr retained_span& operator=(retained_span&&) noexcept = default;
+
+    template <
+        typename U,
+        typename = std::enable_if_t<detail::is_element_convertible_v<U, T>>>
+    constexpr retained_span& operator=(retained_span<U>&& other) noexcept
+    {
+      m_data = other.m_data;
+      m_size = other.m_size;
+      return *this;
+    }
+
+    constexpr T* data() noexcept
+    {
+      return m_data;
+    }
+
+    constexpr T const* data() const noexcept
+    {
+      return m_data;
+    }
+
+    constexpr size_type size() const noexcept
+    {
+      return m_size;
+    }
+
+    constexpr size_type size_bytes() const noexcept
+    {
+      return m_size * sizeof(T);
+    }
+
+    constexpr bool empty() const noexcept
+    {
+      return m_size == 0;
+    }
+
+    constexpr T& operator[](size_type i)
+    {
+      detail::expect_in_bounds(i < m_size);
+      return m_data[i];
+    }
+
+    constexpr T const& operator[](size_type i) const
+    {
+      detail::expect_in_bounds(i < m_size);
+      return m_data[i];
+    }
+
+    constexpr T& front()
+    {
+      detail::expect_in_bounds(m_size != 0);
+      return m_data[0];
+    }
+
+    constexpr T const& front() const
+    {
+      detail::expect_in_bounds(m_size != 0);
+      return m_data[0];
+    }
+
+    constexpr T& back()
+    {
+      detail::expect_in_bounds(m_size != 0);
+      return m_data[m_size - 1];
+    }
+
+    constexpr T const& back() const
+    {
+      detail::expect_in_bounds(m_size != 0);
+      return m_data[m_size - 1];
+    }
+
+    // The iterators are plain pointers, so loops over a `retained_span` are as
+    // easy to vectorize as loops over an array.
+    constexpr T* begin() noexcept
+    {
+      return m_data;
+    }
+
+    constexpr T const* begin() const noexcept
+    {
+      return m_data;
+    }
+
+    constexpr T const* cbegin() const noexcept
+    {
+      return m_data;
+    }
+
+    constexpr T* end() noexcept
+    {
+      return m_data + m_size;
+    }
+
+    constexpr T const* end() const noexcept
+    {
+      return m_data + m_size;
+    }
+
+    constexpr T const* cend() const noexcept
+    {
+      return m_data + m_size;
+    }
+
+    constexpr retained_span first(size_type count)
+    {
+      detail::expect_in_bounds(count <= m_size);
+      return retained_span(m_data, count);
+    }
+
+    constexpr retained_span<T const> first(size_type count) const
+    {
+      detail::expect_in_bounds(count <= m_size);
+      return retained_span<T const>(m_data, count);
+    }
+
+    constexpr retained_span last(size_type count)
+    {
+      detail::expect_in_bounds(count <= m_size);
+      return retained_span(m_data + (m_size - count), count);
+    }
+
+    constexpr retained_span<T const> last(size_type count) const
+    {
+      detail::expect_in_bounds(count <= m_size);
+      return retained_span<T const>(m_data + (m_size - count), count);
+    }
+
+    // A `count` of `npos` selects the elements from `offset` to the end.
+    static constexpr size_type npos = static_cast<size_type>(-1);
+
+    // The size is checked before `offset` is added to the pointer, which would
+    // be undefined if it were out of range.
+    constexpr retained_span subspan(size_type offset, size_type count = npos)
+    {
+      size_type const size = subspan_size(offset, count);
+      return retained_span(m_data + offset, size);
+    }
+
+    constexpr retained_span<T const> subspan(
+        size_type offset, size_type count = npos) const
+    {
+      size_type const size = subspan_size(offset, count);
+      return retained_span<T const>(m_data + offset, size);
+    }
+
+    // `std::swap` is not `constexpr` until C++20.
+    constexpr void swap(retained_span& other) noexcept
+    {
+      T* const data = m_data;
+      size_type const size = m_size;
+      m_data = other.m_data;
+      m_size = other.m_size;
+      other.m_data = data;
+      other.m_size = size;
+    }
+
+  private:
+    constexpr size_type subspan_size(size_type offset, size_type count) const
+    {
+      detail::expect_in_bounds(offset <= m_size);
+
+      if (count == npos)
+      {
+        return m_size - offset;
+      }
+
+      detail::expect_in_bounds(count <= m_size - offset);
+      return count;
+    }
+
+    T* m_data;
+    size_type m_size;
+  };
+
+  // Relocating a `retained_span<T>` only copies the pointer and size it holds.
+  template <typename T>
+  struct is_trivially_relocatable<retained_span<T>> : std::true_type
+  {
+  };
+
+  template <
+      typename C,
+      typename T = detail::container_element_t<C>,
+      typename = std::enable_if_t<detail::is_compatible_container_v<C, T>>>
+  constexpr retained_span<T> make_retained_span(C& c) noexcept
+  {
+    return retained_span<T>(c);
+  }
+
+  template <
+      typename C,
+      typename = std::enable_if_t<
+          !std::is_lvalue_reference_v<C>
+          && detail::is_compatible_container_v<C, detail::container_element_t<C>>>>
+  void make_retained_span(C&&) = delete;
+
+  template <typename T>
+  constexpr retained_span<T> make_retained_span(T* data, std::size_t size) noexcept
+  {
+    return retained_span<T>(data, size);
+  }
+
+  template <typename T>
+  constexpr void swap(retained_span<T>& lhs, retained_span<T>& rhs) noexcept
+  {
+    lhs.swap(rhs);
+  }
+
+#if defined(__cpp_lib_span)
+  // Views the elements of a `retained_span` as a `std::span`, for passing to
+  // interfaces that take one. Constness is carried over from the `retained_span`.
+  template <typename T>
+  constexpr std::span<T> as_span(retained_span<T>& s) noexcept
+  {
+    return std::span<T>(s.data(), s.size());
+  }
+
+  template <typename T>
+  constexpr std::span<T const> as_span(retained_span<T> const& s) noexcept
+  {
+    return std::span<T const>(s.data(), s.size());
+  }
+#endif
+
+} // namespace gsl
+
+#endif // GSL_RETAINED_SPAN_HPP
@@ -0,0 +1,575 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GSL_RETAINED_VECTOR_HPP
+#define GSL_RETAINED_VECTOR_HPP
+
+#include "retained.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__has_include)
+#if __has_include(<span>)
+#include <span>
+#endif
+#endif
+
+namespace gsl
+{
+  namespace detail
+  {
+    // A random access iterator over an array of `T*` that yields `T&`.
+    template <typename T>
+    class indirect_iterator
+    {
+      template <typename>
+      friend class indirect_iterator;
+
+    public:
+      using iterator_category = std::random_access_iterator_tag;
+      using value_type = std::remove_cv_t<T>;
+      using difference_type = std::ptrdiff_t;
+      using pointer = T*;
+      using reference = T&;
+
+      constexpr indirect_iterator() noexcept
+      : m_it()
+      {
+      }
+
+      constexpr explicit indirect_iterator(T* const* it) noexcept
+      : m_it(it)
+      {
+      }
+
+      template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+      constexpr indirect_iterator(indirect_iterator<U> const& other) noexcept
+      : m_it(other.m_it)
+      {
+      }
+
+      constexpr T* const* base() const noexcept
+      {
+        return m_it;
+      }
+
+      constexpr T& operator*() const noexcept
+      {
+        return **m_it;
+      }
+
+      constexpr T* operator->() const noexcept
+      {
+        return *m_it;
+      }
+
+      constexpr T& operator[](difference_type n) const noexcept
+      {
+        return *m_it[n];
+      }
+
+      constexpr indirect_iterator& operator++() noexcept
+      {
+        ++m_it;
+        return *this;
+      }
+
+      constexpr indirect_iterator operator++(int) noexcept
+      {
+        return indirect_iterator(m_it++);
+      }
+
+      constexpr indirect_iterator& operator--() noexcept
+      {
+        --m_it;
+        return *this;
+      }
+
+      constexpr indirect_iterator operator--(int) noexcept
+      {
+        return indirect_iterator(m_it--);
+      }
+
+      constexpr indirect_iterator& operator+=(difference_type n) noexcept
+      {
+        m_it += n;
+        return *this;
+      }
+
+      constexpr indirect_iterator& operator-=(difference_type n) noexcept
+      {
+        m_it -= n;
+        return *this;
+      }
+
+      friend constexpr indirect_iterator
+      operator+(indirect_iterator it, difference_type n) noexcept
+      {
+        return it += n;
+      }
+
+      friend constexpr indirect_iterator
+      operator+(difference_type n, indirect_iterator it) noexcept
+      {
+        return it += n;
+      }
+
+      friend constexpr indirect_iterator
+      operator-(indirect_iterator it, difference_type n) noexcept
+      {
+        return it -= n;
+      }
+
+      friend constexpr difference_type
+      operator-(indirect_iterator const& lhs, indirect_iterator const& rhs) noexcept
+      {
+        return lhs.m_it - rhs.m_it;
+      }
+
+      friend constexpr bool
+      operator==(indirect_iterator const& lhs, indirect_iterator const& rhs) noexcept
+      {
+        return lhs.m_it == rhs.m_it;
+      }
+
+      friend constexpr bool
+      operator!=(indirect_iterator const& lhs, indirect_iterator const& rhs) noexcept
+      {
+        return lhs.m_it != rhs.m_it;
+      }
+
+      friend constexpr bool
+      operator<(indirect_iterator const& lhs, indirect_iterator const& rhs) noexcept
+      {
+        return lhs.m_it < rhs.m_it;
+      }
+
+      friend constexpr bool
+      operator<=(indirect_iterator const& lhs, indirect_iterator const& rhs) noexcept
+      {
+        return lhs.m_it <= rhs.m_it;
+      }
+
+      friend constexpr bool
+      operator>(indirect_iterator const& lhs, indirect_iterator const& rhs) noexcept
+      {
+        return lhs.m_it > rhs.m_it;
+      }
+
+      friend constexpr bool
+      operator>=(indirect_iterator const& lhs, indirect_iterator const& rhs) noexcept
+      {
+        return lhs.m_it >= rhs.m_it;
+      }
+
+    private:
+      T* const* m_it;
+    };
+
+    // Whether `V` is a `retained<U>` that can be stored in a container of
+    // `retained<T>`.
+    template <typename V, typename T>
+    struct is_retained_of : std::false_type
+    {
+    };
+
+    template <typename U, typename T>
+    struct is_retained_of<retained<U>, T> : std::is_convertible<U*, T*>
+    {
+    };
+
+    // Whether `InputIt` dereferences to a `retained<U>` through which a `T&` can
+    // be obtained, which is not the case for a `retained<T> const` when `T` is
+    // not const.
+    template <typename InputIt, typename T, typename = void>
+    inline constexpr bool is_retained_iterator_of_v = false;
+
+    template <typename InputIt, typename T>
+    inline constexpr bool is_retained_iterator_of_v<
+        InputIt,
+        T,
+        std::void_t<decltype(**std::declval<InputIt&>())>> =
+        is_retained_of<
+            std::remove_cv_t<
+                std::remove_reference_t<decltype(*std::declval<InputIt&>())>>,
+            T>::value
+        && std::is_convertible_v<decltype(**std::declval<InputIt&>()), T&>;
+  } // namespace detail
+
+  enum class retained_vector_order
+  {
+    // Elements are kept in the order in which they were inserted.
+    insertion,
+    // Elements are kept sorted by address, so that they can be found by binary
+    // search.
+    address
+  };
+
+  // A contiguous sequence of `retained<T>` stored as an array of `T*`, so that
+  // it can be grown, reordered and passed to C APIs without per-element
+  // moves or copies. Like `retained<T>`, it is move-only and gives read-only
+  // access to the referenced objects when it is itself read-only.
+  template <typename T, retained_vector_order Order = retained_vector_order::insertion>
+  class retained_vector
+  {
+    static constexpr bool sorted = Order == retained_vector_order::address;
+
+  public:
+    using element_type = T;
+    using value_type = retained<T>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = T const&;
+    using iterator = detail::indirect_iterator<T>;
+    using const_iterator = detail::indirect_iterator<T const>;
+
+    retained_vector() noexcept = default;
+
+    retained_vector(retained_vector const&) = delete;
+    retained_vector(retained_vector&&) noexcept = default;
+
+    retained_vector& operator=(retained_vector const&) = delete;
+    retained_vector& operator=(retained_vector&&) noexcept = default;
+
+    iterator begin() noexcept
+    {
+      return iterator(m_ptrs.data());
+    }
+
+    const_iterator begin() const noexcept
+    {
+      return const_iterator(data());
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+      return begin();
+    }
+
+    iterator end() noexcept
+    {
+      return iterator(m_ptrs.data() + m_ptrs.size());
+    }
+
+    const_iterator end() const noexcept
+    {
+      return const_iterator(data() + m_ptrs.size());
+    }
+
+    const_iterator cend() const noexcept
+    {
+      return end();
+    }
+
+    bool empty() const noexcept
+    {
+      return m_ptrs.empty();
+    }
+
+    size_type size() const noexcept
+    {
+      return m_ptrs.size();
+    }
+
+    size_type capacity() const noexcept
+    {
+      return m_ptrs.capacity();
+    }
+
+    void reserve(size_type n)
+    {
+      m_ptrs.reserve(n);
+    }
+
+    void shrink_to_fit()
+    {
+      m_ptrs.shrink_to_fit();
+    }
+
+    T& operator[](size_type i) noexcept
+    {
+      return *m_ptrs[i];
+    }
+
+    T const& operator[](size_type i) const noexcept
+    {
+      return *m_ptrs[i];
+    }
+
+    T& at(size_type i)
+    {
+      return *m_ptrs.at(i);
+    }
+
+    T const& at(size_type i) const
+    {
+      return *m_ptrs.at(i);
+    }
+
+    T& front() noexcept
+    {
+      return *m_ptrs.front();
+    }
+
+    T const& front() const noexcept
+    {
+      return *m_ptrs.front();
+    }
+
+    T& back() noexcept
+    {
+      return *m_ptrs.back();
+    }
+
+    T const& back() const noexcept
+    {
+      return *m_ptrs.back();
+    }
+
+    // The underlying array of pointers, for passing to C APIs.
+    T* const* data() noexcept
+    {
+      return m_ptrs.data();
+    }
+
+    T const* const* data() const noexcept
+    {
+      return m_ptrs.data();
+    }
+
+#if defined(__cpp_lib_span)
+    std::span<T* const> pointers() noexcept
+    {
+      return {data(), size()};
+    }
+
+    std::span<T const* const> pointers() const noexcept
+    {
+      return {data(), size()};
+    }
+#endif
+
+    // Appends `r` in insertion order, or inserts it at its position by address
+    // in address order.
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    iterator insert(retained<U>&& r)
+    {
+      T* const p = std::addressof(*r);
+      auto const it = sorted ? lower_bound_of(p) : m_ptrs.end();
+      return iterator(&*m_ptrs.insert(it, p));
+    }
+
+    // Inserts the objects referenced by a range of `retained<U>`. The range is
+    // only read from, but the elements must give non-const access to the objects
+    // unless `T` is const.
+    template <
+        typename InputIt,
+        typename = std::enable_if_t<detail::is_retained_iterator_of_v<InputIt, T>>>
+    void insert(InputIt first, InputIt last)
+    {
+      auto const n = m_ptrs.size();
+
+      for (; first != last; ++first)
+      {
+        m_ptrs.push_back(std::addressof(**first));
+      }
+
+      if constexpr (sorted)
+      {
+        auto const middle = m_ptrs.begin() + static_cast<difference_type>(n);
+        std::sort(middle, m_ptrs.end(), std::less<T*>());
+        std::inplace_merge(m_ptrs.begin(), middle, m_ptrs.end(), std::less<T*>());
+      }
+    }
+
+    template <
+        typename U,
+        typename = std::enable_if_t<std::is_convertible_v<U*, T*>>,
+        retained_vector_order O = Order,
+        typename = std::enable_if_t<O == retained_vector_order::insertion>>
+    iterator insert(const_iterator pos, retained<U>&& r)
+    {
+      auto const it = m_ptrs.begin() + (pos - cbegin());
+      return iterator(&*m_ptrs.insert(it, std::addressof(*r)));
+    }
+
+    template <
+        typename U,
+        typename = std::enable_if_t<std::is_convertible_v<U*, T*>>,
+        retained_vector_order O = Order,
+        typename = std::enable_if_t<O == retained_vector_order::insertion>>
+    void push_back(retained<U>&& r)
+    {
+      m_ptrs.push_back(std::addressof(*r));
+    }
+
+    void pop_back() noexcept
+    {
+      m_ptrs.pop_back();
+    }
+
+    iterator erase(const_iterator pos) noexcept
+    {
+      auto const it = m_ptrs.begin() + (pos - cbegin());
+      return iterator(m_ptrs.data() + (m_ptrs.erase(it) - m_ptrs.begin()));
+    }
+
+    iterator erase(const_iterator first, const_iterator last) noexcept
+    {
+      auto const b = m_ptrs.begin() + (first - cbegin());
+      auto const e = m_ptrs.begin() + (last - cbegin());
+      return iterator(m_ptrs.data() + (m_ptrs.erase(b, e) - m_ptrs.begin()));
+    }
+
+    // Returns an iterator to the first element referencing `t`, or `end()`.
+    iterator find(T const& t) noexcept
+    {
+      return begin() + static_cast<difference_type>(index_of(std::addressof(t)));
+    }
+
+    const_iterator find(T const& t) const noexcept
+    {
+      return begin() + static_cast<difference_type>(index_of(std::addressof(t)));
+    }
+
+    // A temporary is never referenced by an element.
+    iterator find(T const&&) noexcept = delete;
+    const_iterator find(T const&&) const noexcept = delete;
+
+    bool contains(T const& t) const noexcept
+    {
+      return index_of(std::addressof(t)) != size();
+    }
+
+    bool contains(T const&&) const noexcept = delete;
+
+    // Removes the first element referencing `t`, preserving the order of the
+    // remaining elements. Returns whether an element was removed.
+    bool erase(T const& t) noexcept
+    {
+      auto const i = index_of(std::addressof(t));
+
+      if (i == size())
+      {
+        return false;
+      }
+
+      m_ptrs.erase(m_ptrs.begin() + static_cast<difference_type>(i));
+      return true;
+    }
+
+    bool erase(T const&&) noexcept = delete;
+
+    // Removes the element at `pos` by replacing it with the last element.
+    template <
+        retained_vector_order O = Order,
+        typename = std::enable_if_t<O == retained_vector_order::insertion>>
+    void swap_remove(const_iterator pos) noexcept
+    {
+      m_ptrs[static_cast<size_type>(pos - cbegin())] = m_ptrs.back();
+      m_ptrs.pop_back();
+    }
+
+    // Removes the first element referencing `t` by replacing it with the last
+    // element. Returns whether an element was removed.
+    template <
+        retained_vector_order O = Order,
+        typename = std::enable_if_t<O == retained_vector_order::insertion>>
+    bool swap_remove(T const& t) noexcept
+    {
+      auto const i = index_of(std::addressof(t));
+
+      if (i == size())
+      {
+        return false;
+      }
+
+      m_ptrs[i] = m_ptrs.back();
+      m_ptrs.pop_back();
+      return true;
+    }
+
+    template <
+        retained_vector_order O = Order,
+        typename = std::enable_if_t<O == retained_vector_order::insertion>>
+    bool swap_remove(T const&&) noexcept = delete;
+
+    void clear() noexcept
+    {
+      m_ptrs.clear();
+    }
+
+    void swap(retained_vector& other) noexcept
+    {
+      m_ptrs.swap(other.m_ptrs);
+    }
+
+  private:
+    using storage = std::vector<T*>;
+
+    typename storage::iterator lower_bound_of(T const* p) noexcept
+    {
+      return std::lower_bound(m_ptrs.begin(), m_ptrs.end(), p, std::less<T const*>());
+    }
+
+    // Returns the index of the first element referencing `p`, or `size()`.
+    size_type index_of(T const* p) const noexcept
+    {
+      if constexpr (sorted)
+      {
+        auto const it =
+            std::lower_bound(m_ptrs.begin(), m_ptrs.end(), p, std::less<T const*>());
+        return (it != m_ptrs.end() && *it == p)
+            ? static_cast<size_type>(it - m_ptrs.begin())
+            : size();
+      }
+      else
+      {
+        return static_cast<size_type>(
+            std::find(m_ptrs.begin(), m_ptrs.end(), p) - m_ptrs.begin());
+      }
+    }
+
+    storage m_ptrs;
+  };
+
+  template <typename T>
+  using sorted_retained_vector = retained_vector<T, retained_vector_order::address>;
+
+  template <typename T, retained_vector_order Order>
+  void swap(retained_vector<T, Order>& lhs, retained_vector<T, Order>& rhs) noexcept
+  {
+    lhs.swap(rhs);
+  }
+
+} // namespace gsl
+
+#endif // GSL_RETAINED_VECTOR_HPP
@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GSL_SNAPSHOT_HPP
+#define GSL_SNAPSHOT_HPP
+
+#include "optional_retained.hpp"
+#include "retained.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gsl
+{
+  namespace detail
+  {
+    template <typename T, typename F>
+    struct snapshot_field;
+
+    template <typename T, typename U>
+    struct snapshot_field<T, retained<U> T::*>
+    {
+      static_assert(std::is_same_v<std::remove_const_t<U>, T>);
+
+      static constexpr bool nullable = false;
+
+      static T const* get(retained<U> const& f) noexcept
+      {
+        return &*f;
+      }
+
+      static void set(retained<U>& f, T* p) noexcept
+      {
+        f = retained<U>(*p);
+      }
+    };
+
+    template <typename T, typename U>
+    struct snapshot_field<T, optional_retained<U> T::*>
+    {
+      static_assert(std::is_same_v<std::remove_const_t<U>, T>);
+
+      static constexpr bool nullable = true;
+
+      static T const* get(optional_retained<U> const& f) noexcept
+      {
+        return f ? &*f : nullptr;
+      }
+
+      static void set(optional_retained<U>& f, T* p) noexcept
+      {
+        if (p)
+        {
+          f = retained<U>(*p);
+        }
+        else
+        {
+          f = std::nullopt;
+        }
+      }
+    };
+
+    struct snapshot_header
+    {
+      std::uint64_t magic;
+      std::uint64_t node_size;
+      std::uint64_t node_alignment;
+      std::uint64_t field_count;
+      std::uint64_t count;
+    };
+  } // namespace detail
+
+  // Describes a binary snapshot format for arrays of `T` whose `retained<T>`,
+  // `retained<T const>`, `optional_retained<T>` and `optional_retained<T const>`
+  // data members, given by `Fields`, reference other elements of the same
+  // array.
+  //
+  // On write, each registered field is swizzled into the index of the element
+  // it references. On load, the snapshot is unswizzled in place, so a
+  // snapshot that has been mapped into memory becomes usable after a single
+  // pass over its fields, without allocation or reparsing. Snapshots are only
+  // portable between builds that agree on the layout of `T`.
+  template <typename T, auto... Fields>
+  class snapshot_format
+  {
+    static_assert(
+        std::is_trivially_copyable_v<T>,
+        "snapshot elements must be trivially copyable");
+
+    static constexpr std::uint64_t magic = 0x70616e73'6c73670aull;
+    static constexpr std::uintptr_t null_index = ~std::uintptr_t();
+
+  public:
+    // The required alignment of snapshot storage.
+    static constexpr std::size_t alignment =
+        alignof(T) > alignof(detail::snapshot_header) ? alignof(T)
+                                                      : alignof(detail::snapshot_header);
+
+    // Returns the number of bytes required to store a snapshot of `count`
+    // elements.
+    static constexpr std::size_t size(std::size_t count) noexcept
+    {
+      return data_offset + count * sizeof(T);
+    }
+
+    // Writes a snapshot of `count` elements to `out`, which must be suitably
+    // aligned and at least `size(count)` bytes in size. Throws
+    // `std::invalid_argument` if any field references an object outside of the
+    // array.
+    static void write(T const* nodes, std::size_t count, void* out)
+    {
+      auto const bytes = static_cast<unsigned char*>(out);
+
+      detail::snapshot_header const header = {
+          magic, sizeof(T), alignof(T), sizeof...(Fields), count};
+      std::memcpy(bytes, &header, sizeof(header));
+
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        unsigned char* const node = bytes + data_offset + i * sizeof(T);
+        std::memcpy(node, &nodes[i], sizeof(T));
+        (swizzle<Fields>(nodes, count, nodes[i], node), ...);
+      }
+    }
+
+    static std::vector<unsigned char> write(T const* nodes, std::size_t count)
+    {
+      std::vector<unsigned char> bytes(size(count));
+      write(nodes, count, bytes.data());
+      return bytes;
+    }
+
+    // Unswizzles the snapshot stored in `data` in place and returns the array
+    // of elements it contains. Throws `std::invalid_argument` if `data` does
+    // not hold a valid snapshot in this format.
+    static std::pair<T*, std::size_t> load(void* data, std::size_t size)
+    {
+      auto const bytes = static_cast<unsigned char*>(data);
+
+      if (reinterpret_cast<std::uintptr_t>(data) % alignment != 0)
+      {
+        throw std::invalid_argument("snapshot storage is misaligned");
+      }
+
+      detail::snapshot_header header;
+
+      if (size < data_offset)
+      {
+        throw std::invalid_argument("snapshot is truncated");
+      }
+
+      std::memcpy(&header, bytes, sizeof(header));
+
+      if (header.magic != magic || header.node_size != sizeof(T)
+          || header.node_alignment != alignof(T)
+          || header.field_count != sizeof...(Fields))
+      {
+        throw std::invalid_argument("snapshot does not match format");
+      }
+
+      if (header.count > (size - data_offset) / sizeof(T))
+      {
+        throw std::invalid_argument("snapshot is truncated");
+      }
+
+      auto const count = static_cast<std::size_t>(header.count);
+      T* const nodes = std::launder(reinterpret_cast<T*>(bytes + data_offset));
+
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        (unswizzle<Fields>(nodes, count, nodes[i]), ...);
+      }
+
+      return {nodes, count};
+    }
+
+  private:
+    static constexpr std::size_t data_offset =
+        (sizeof(detail::snapshot_header) + alignment - 1) / alignment * alignment;
+
+    template <auto Field>
+    using field = detail::snapshot_field<T, decltype(Field)>;
+
+    template <auto Field>
+    static std::size_t field_offset(T const& node) noexcept
+    {
+      return static_cast<std::size_t>(
+          reinterpret_cast<unsigned char const*>(&(node.*Field))
+          - reinterpret_cast<unsigned char const*>(&node));
+    }
+
+    template <auto Field>
+    static void
+    swizzle(T const* nodes, std::size_t count, T const& node, unsigned char* out)
+    {
+      static_assert(sizeof(node.*Field) == sizeof(std::uintptr_t));
+
+      T const* const p = field<Field>::get(node.*Field);
+      std::uintptr_t index = null_index;
+
+      if (p != nullptr)
+      {
+        // Compare addresses as integers, as `p` need not point into `nodes`.
+        auto const offset =
+            reinterpret_cast<std::uintptr_t>(p) - reinterpret_cast<std::uintptr_t>(nodes);
+
+        if (offset % sizeof(T) != 0 || offset / sizeof(T) >= count)
+        {
+          throw std::invalid_argument("field references an object outside of snapshot");
+        }
+
+        index = offset / sizeof(T);
+      }
+
+      std::memcpy(out + field_offset<Field>(node), &index, sizeof(index));
+    }
+
+    template <auto Field>
+    static void unswizzle(T* nodes, std::size_t count, T& node)
+    {
+      std::uintptr_t index;
+      std::memcpy(
+          &index,
+          reinterpret_cast<unsigned char const*>(&node) + field_offset<Field>(node),
+          sizeof(index));
+
+      if (index == null_index && field<Field>::nullable)
+      {
+        field<Field>::set(node.*Field, nullptr);
+      }
+      else if (index < count)
+      {
+        field<Field>::set(node.*Field, &nodes[index]);
+      }
+      else
+      {
+        throw std::invalid_argument("snapshot field index is out of range");
+      }
+    }
+  };
+
+} // namespace gsl
+
+#endif // GSL_SNAPSHOT_HPP
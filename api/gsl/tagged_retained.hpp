@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GSL_TAGGED_RETAINED_HPP
+#define GSL_TAGGED_RETAINED_HPP
+
+#include "contract.hpp"
+#include "relocatable.hpp"
+#include "retained.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#if __has_include(<version>)
+#include <version>
+#endif
+
+#if !defined(__cpp_lib_atomic_ref) && !defined(__GNUC__) && !defined(__clang__)
+#error "tagged_retained requires std::atomic_ref or the GCC atomic builtins"
+#endif
+
+namespace gsl
+{
+  namespace detail
+  {
+#if !defined(__cpp_lib_atomic_ref)
+    constexpr int builtin_memory_order(std::memory_order order) noexcept
+    {
+      switch (order)
+      {
+      case std::memory_order_relaxed:
+        return __ATOMIC_RELAXED;
+      case std::memory_order_consume:
+        return __ATOMIC_CONSUME;
+      case std::memory_order_acquire:
+        return __ATOMIC_ACQUIRE;
+      case std::memory_order_release:
+        return __ATOMIC_RELEASE;
+      case std::memory_order_acq_rel:
+        return __ATOMIC_ACQ_REL;
+      default:
+        return __ATOMIC_SEQ_CST;
+      }
+    }
+#endif
+
+    // Atomic operations on a plain `uintptr_t`, via `std::atomic_ref` where
+    // available.
+    inline std::uintptr_t atomic_load(std::uintptr_t const& bits, std::memory_order order)
+    {
+#if defined(__cpp_lib_atomic_ref)
+      // `atomic_ref<T const>` is not supported before C++26.
+      auto& mutable_bits = const_cast<std::uintptr_t&>(bits);
+      return std::atomic_ref<std::uintptr_t>(mutable_bits).load(order);
+#else
+      return __atomic_load_n(&bits, builtin_memory_order(order));
+#endif
+    }
+
+    inline std::uintptr_t atomic_fetch_or(
+        std::uintptr_t& bits, std::uintptr_t value, std::memory_order order)
+    {
+#if defined(__cpp_lib_atomic_ref)
+      return std::atomic_ref<std::uintptr_t>(bits).fetch_or(value, order);
+#else
+      return __atomic_fetch_or(&bits, value, builtin_memory_order(order));
+#endif
+    }
+
+    inline std::uintptr_t atomic_fetch_and(
+        std::uintptr_t& bits, std::uintptr_t value, std::memory_order order)
+    {
+#if defined(__cpp_lib_atomic_ref)
+      return std::atomic_ref<std::uintptr_t>(bits).fetch_and(value, order);
+#else
+      return __atomic_fetch_and(&bits, value, builtin_memory_order(order));
+#endif
+    }
+  } // namespace detail
+
+  // A `retained<T>` that stores a tag of `Bits` bits in the low bits of the
+  // pointer, which are always zero because of the alignment of `T`. The tag
+  // can be modified atomically to allow concurrent marking, although the
+  // reference itself cannot, and atomic and non-atomic accesses to the same
+  // `tagged_retained` must not race. Tags greater than `max_tag` are contract
+  // violations, checked in hardened builds.
+  template <typename T, std::size_t Bits>
+  class GSL_TRIVIALLY_RELOCATABLE tagged_retained
+  {
+    static_assert(Bits > 0, "at least one tag bit is required");
+    static_assert(
+        (std::size_t(1) << Bits) <= alignof(T),
+        "the alignment of `T` leaves too few unused pointer bits for the tag");
+
+    template <typename, std::size_t>
+    friend class tagged_retained;
+
+  public:
+    using element_type = T;
+    using tag_type = std::uintptr_t;
+
+    static constexpr tag_type max_tag = (tag_type(1) << Bits) - 1;
+
+    explicit tagged_retained(T& t, tag_type tag = 0)
+    : m_bits(reinterpret_cast<std::uintptr_t>(std::addressof(t)) | checked_tag(tag))
+    {
+    }
+
+    explicit tagged_retained(T&&, tag_type = 0) noexcept = delete;
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    explicit tagged_retained(retained<U>&& r, tag_type tag = 0)
+    : tagged_retained(static_cast<T&>(*r), tag)
+    {
+    }
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    tagged_retained(tagged_retained<U, Bits>&& other) noexcept
+    : tagged_retained(static_cast<T&>(*other), other.tag())
+    {
+    }
+
+    tagged_retained(tagged_retained const&) noexcept = delete;
+    tagged_retained(tagged_retained&&) noexcept = default;
+
+    tagged_retained& operator=(tagged_retained const&) noexcept = delete;
+    tagged_retained& operator=(tagged_retained&&) noexcept = default;
+
+    T* get() noexcept
+    {
+      return reinterpret_cast<T*>(m_bits & ~max_tag);
+    }
+
+    T const* get() const noexcept
+    {
+      return reinterpret_cast<T const*>(m_bits & ~max_tag);
+    }
+
+    T& operator*() noexcept
+    {
+      return *get();
+    }
+
+    T const& operator*() const noexcept
+    {
+      return *get();
+    }
+
+    T* operator->() noexcept
+    {
+      return get();
+    }
+
+    T const* operator->() const noexcept
+    {
+      return get();
+    }
+
+    operator T const*() const noexcept
+    {
+      return get();
+    }
+
+    tag_type tag() const noexcept
+    {
+      return m_bits & max_tag;
+    }
+
+    void set_tag(tag_type tag)
+    {
+      m_bits = (m_bits & ~max_tag) | checked_tag(tag);
+    }
+
+    tag_type load_tag(std::memory_order order = std::memory_order_seq_cst) const noexcept
+    {
+      return detail::atomic_load(m_bits, order) & max_tag;
+    }
+
+    // Sets the bits of `tag` in the tag and returns the previous tag.
+    tag_type
+    fetch_or_tag(tag_type tag, std::memory_order order = std::memory_order_seq_cst)
+    {
+      return detail::atomic_fetch_or(m_bits, checked_tag(tag), order) & max_tag;
+    }
+
+    // Clears the bits not in `tag` from the tag and returns the previous tag.
+    tag_type
+    fetch_and_tag(tag_type tag, std::memory_order order = std::memory_order_seq_cst)
+    {
+      return detail::atomic_fetch_and(m_bits, checked_tag(tag) | ~max_tag, order)
+          & max_tag;
+    }
+
+    void swap(tagged_retained& other) noexcept
+    {
+      using std::swap;
+      swap(m_bits, other.m_bits);
+    }
+
+  private:
+    static tag_type checked_tag(tag_type tag)
+    {
+      detail::expect(tag <= max_tag, "tag is out of range");
+      return tag;
+    }
+
+    std::uintptr_t m_bits;
+  };
+
+  template <typename T, std::size_t Bits>
+  struct is_trivially_relocatable<tagged_retained<T, Bits>> : std::true_type
+  {
+  };
+
+  template <std::size_t Bits, typename T>
+  tagged_retained<T, Bits> make_tagged_retained(T& t, std::uintptr_t tag = 0)
+  {
+    return tagged_retained<T, Bits>(t, tag);
+  }
+
+  template <std::size_t Bits, typename T>
+  tagged_retained<T, Bits> make_tagged_retained(T&&, std::uintptr_t = 0) = delete;
+
+  template <typename T, std::size_t Bits>
+  void swap(tagged_retained<T, Bits>& lhs, tagged_retained<T, Bits>& rhs) noexcept
+  {
+    lhs.swap(rhs);
+  }
+
+  // Compares the referenced objects, ignoring the tags.
+  template <typename T1, typename T2, std::size_t Bits>
+  bool operator==(
+      tagged_retained<T1, Bits> const& lhs, tagged_retained<T2, Bits> const& rhs) noexcept
+  {
+    return &*lhs == &*rhs;
+  }
+
+  template <typename T1, typename T2, std::size_t Bits>
+  bool operator!=(
+      tagged_retained<T1, Bits> const& lhs, tagged_retained<T2, Bits> const& rhs) noexcept
+  {
+    return !(lhs == rhs);
+  }
+} // namespace gsl
+
+#endif // GSL_TAGGED_RETAINED_HPP
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GSL_UTILITY_HPP
+#define GSL_UTILITY_HPP
+
+#include <type_traits>
+
+namespace gsl
+{
+  namespace detail
+  {
+    // `std::addressof` and `std::invoke` are declared in `<memory>` and
+    // `<functional>`, which are much more expensive to include than the types
+    // that use them.
+    template <typename T>
+    constexpr T* addressof(T& t) noexcept
+    {
+      return __builtin_addressof(t);
+    }
+
+    template <typename T>
+    T const* addressof(T const&&) = delete;
+
+    template <typename F>
+    constexpr decltype(auto) invoke(F&& f)
+    {
+      return static_cast<F&&>(f)();
+    }
+
+    template <typename F, typename T>
+    constexpr decltype(auto) invoke(F&& f, T& t)
+    {
+      if constexpr (std::is_member_function_pointer_v<std::remove_reference_t<F>>)
+      {
+        return (t.*f)();
+      }
+      else if constexpr (std::is_member_object_pointer_v<std::remove_reference_t<F>>)
+      {
+        return (t.*f);
+      }
+      else
+      {
+        return static_cast<F&&>(f)(t);
+      }
+    }
+  } // namespace detail
+} // namespace gsl
+
+#endif // GSL_UTILITY_HPP
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "callees.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace
+{
+  std::vector<int> make_values()
+  {
+    return std::vector<int>(1024, 1);
+  }
+
+  // Every other argument is "no object" for the nullable parameter types.
+  void call_pointer(benchmark::State& state)
+  {
+    auto values = make_values();
+
+    for (auto _ : state)
+    {
+      int sum = 0;
+
+      for (std::size_t i = 0; i < values.size(); ++i)
+      {
+        sum += bench::read_pointer(i % 2 ? &values[i] : nullptr);
+      }
+
+      benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * 1024);
+  }
+
+  void call_optional_ref(benchmark::State& state)
+  {
+    auto values = make_values();
+
+    for (auto _ : state)
+    {
+      int sum = 0;
+
+      for (std::size_t i = 0; i < values.size(); ++i)
+      {
+        sum += bench::read_optional_ref(
+            i % 2 ? gsl::optional_ref<int const>(values[i]) : std::nullopt);
+      }
+
+      benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * 1024);
+  }
+
+  void call_optional_ref_temporary(benchmark::State& state)
+  {
+    for (auto _ : state)
+    {
+      int sum = 0;
+
+      for (int i = 0; i < 1024; ++i)
+      {
+        sum += bench::read_optional_ref(i);
+      }
+
+      benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * 1024);
+  }
+
+  void call_reference_wrapper(benchmark::State& state)
+  {
+    auto values = make_values();
+
+    for (auto _ : state)
+    {
+      int sum = 0;
+
+      for (auto const& value : values)
+      {
+        sum += bench::read_reference_wrapper(std::cref(value));
+      }
+
+      benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * 1024);
+  }
+
+  void call_not_null(benchmark::State& state)
+  {
+    auto values = make_values();
+
+    for (auto _ : state)
+    {
+      int sum = 0;
+
+      for (auto const& value : values)
+      {
+        sum += bench::read_not_null(bench::not_null<int const*>(&value));
+      }
+
+      benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * 1024);
+  }
+
+  void call_retained(benchmark::State& state)
+  {
+    auto values = make_values();
+
+    for (auto _ : state)
+    {
+      int sum = 0;
+
+      for (auto const& value : values)
+      {
+        sum += bench::read_retained(gsl::make_retained(value));
+      }
+
+      benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * 1024);
+  }
+
+} // namespace
+
+BENCHMARK(call_pointer);
+BENCHMARK(call_optional_ref);
+BENCHMARK(call_optional_ref_temporary);
+BENCHMARK(call_reference_wrapper);
+BENCHMARK(call_not_null);
+BENCHMARK(call_retained);
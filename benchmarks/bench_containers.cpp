@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "policies.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+  struct widget
+  {
+    int value = {};
+  };
+
+  std::vector<widget> make_widgets(std::size_t count)
+  {
+    std::vector<widget> widgets(count);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      widgets[i].value = static_cast<int>(i);
+    }
+
+    return widgets;
+  }
+
+  std::vector<std::size_t> shuffled_indices(std::size_t count)
+  {
+    std::vector<std::size_t> indices(count);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      indices[i] = i;
+    }
+
+    std::shuffle(indices.begin(), indices.end(), std::mt19937(42));
+
+    return indices;
+  }
+
+  template <typename Policy>
+  void vector_push_back(benchmark::State& state)
+  {
+    auto const count = static_cast<std::size_t>(state.range(0));
+    auto widgets = make_widgets(count);
+
+    for (auto _ : state)
+    {
+      std::vector<typename Policy::template ref<widget>> refs;
+
+      for (auto& w : widgets)
+      {
+        refs.push_back(Policy::make(w));
+      }
+
+      benchmark::DoNotOptimize(refs.data());
+      benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  template <typename Policy>
+  void vector_reserve_push_back(benchmark::State& state)
+  {
+    auto const count = static_cast<std::size_t>(state.range(0));
+    auto widgets = make_widgets(count);
+
+    for (auto _ : state)
+    {
+      std::vector<typename Policy::template ref<widget>> refs;
+      refs.reserve(count);
+
+      for (auto& w : widgets)
+      {
+        refs.push_back(Policy::make(w));
+      }
+
+      benchmark::DoNotOptimize(refs.data());
+      benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  template <typename Policy>
+  void sort_by_address(benchmark::State& state)
+  {
+    using less = typename bench::container_traits<Policy, widget>::less;
+
+    auto const count = static_cast<std::size_t>(state.range(0));
+    auto widgets = make_widgets(count);
+    auto indices = shuffled_indices(count);
+
+    for (auto _ : state)
+    {
+      state.PauseTiming();
+      std::vector<typename Policy::template ref<widget>> refs;
+      refs.reserve(count);
+
+      for (auto i : indices)
+      {
+        refs.push_back(Policy::make(widgets[i]));
+      }
+      state.ResumeTiming();
+
+      std::sort(refs.begin(), refs.end(), less());
+
+      benchmark::DoNotOptimize(refs.data());
+      benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  template <typename Policy>
+  void unordered_map_find(benchmark::State& state)
+  {
+    using traits = bench::container_traits<Policy, widget>;
+    using ref = typename Policy::template ref<widget>;
+
+    auto const count = static_cast<std::size_t>(state.range(0));
+    auto widgets = make_widgets(count);
+    auto indices = shuffled_indices(count);
+
+    std::unordered_map<ref, int, typename traits::hash, typename traits::equal_to> map;
+
+    for (auto& w : widgets)
+    {
+      map.emplace(Policy::make(w), w.value);
+    }
+
+    std::vector<ref> keys;
+    keys.reserve(count);
+
+    for (auto i : indices)
+    {
+      keys.push_back(Policy::make(widgets[i]));
+    }
+
+    for (auto _ : state)
+    {
+      int sum = 0;
+
+      for (auto const& key : keys)
+      {
+        sum += map.find(key)->second;
+      }
+
+      benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+} // namespace
+
+#define GSL_BENCHMARK_POLICIES(name)                                                     \
+  BENCHMARK_TEMPLATE(name, bench::raw_pointer)->Range(1 << 6, 1 << 16);                  \
+  BENCHMARK_TEMPLATE(name, bench::reference_wrapper)->Range(1 << 6, 1 << 16);            \
+  BENCHMARK_TEMPLATE(name, bench::not_null_pointer)->Range(1 << 6, 1 << 16);             \
+  BENCHMARK_TEMPLATE(name, bench::retained)->Range(1 << 6, 1 << 16)
+
+GSL_BENCHMARK_POLICIES(vector_push_back);
+BENCHMARK_TEMPLATE(vector_push_back, bench::optional_ref)->Range(1 << 6, 1 << 16);
+
+GSL_BENCHMARK_POLICIES(vector_reserve_push_back);
+BENCHMARK_TEMPLATE(vector_reserve_push_back, bench::optional_ref)->Range(1 << 6, 1 << 16);
+
+// `optional_ref` is not copy assignable, so it cannot be sorted in place, and
+// its `std::hash` specialization hashes values rather than addresses.
+GSL_BENCHMARK_POLICIES(sort_by_address);
+GSL_BENCHMARK_POLICIES(unordered_map_find);
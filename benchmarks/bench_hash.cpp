@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gsl/retained.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace
+{
+  struct alignas(64) node
+  {
+    int value = {};
+  };
+
+  // A minimal linear probing hash set with a power-of-two capacity, as used by
+  // most open addressing hash table implementations.
+  template <typename Hash>
+  class linear_probing_set
+  {
+  public:
+    explicit linear_probing_set(std::size_t capacity)
+    : m_slots(capacity, nullptr)
+    , m_mask(capacity - 1)
+    {
+    }
+
+    // Returns the number of slots examined before the key was found or inserted.
+    std::size_t insert(gsl::retained<node> const& key)
+    {
+      std::size_t probes = 1;
+
+      for (auto i = Hash()(key) & m_mask;; i = (i + 1) & m_mask, ++probes)
+      {
+        if (m_slots[i] == nullptr)
+        {
+          m_slots[i] = &*key;
+          return probes;
+        }
+
+        if (m_slots[i] == &*key)
+        {
+          return probes;
+        }
+      }
+    }
+
+    bool contains(gsl::retained<node> const& key) const
+    {
+      for (auto i = Hash()(key) & m_mask;; i = (i + 1) & m_mask)
+      {
+        if (m_slots[i] == &*key)
+        {
+          return true;
+        }
+
+        if (m_slots[i] == nullptr)
+        {
+          return false;
+        }
+      }
+    }
+
+  private:
+    std::vector<node const*> m_slots;
+    std::size_t m_mask;
+  };
+
+  template <typename Hash>
+  void open_addressing_probe_length(benchmark::State& state)
+  {
+    auto const count = static_cast<std::size_t>(state.range(0));
+    std::vector<node> nodes(count);
+
+    // A load factor of one half.
+    linear_probing_set<Hash> set(count * 2);
+    std::size_t probes = 0;
+
+    for (auto& n : nodes)
+    {
+      probes += set.insert(gsl::make_retained(n));
+    }
+
+    for (auto _ : state)
+    {
+      std::size_t found = 0;
+
+      for (auto& n : nodes)
+      {
+        found += set.contains(gsl::make_retained(n));
+      }
+
+      benchmark::DoNotOptimize(found);
+    }
+
+    state.counters["mean_probe_length"] =
+        static_cast<double>(probes) / static_cast<double>(count);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+} // namespace
+
+BENCHMARK_TEMPLATE(open_addressing_probe_length, std::hash<gsl::retained<node>>)
+    ->Range(1 << 6, 1 << 14);
+BENCHMARK_TEMPLATE(open_addressing_probe_length, gsl::retained_hash<node>)
+    ->Range(1 << 6, 1 << 14);
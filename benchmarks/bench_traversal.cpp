@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "policies.hpp"
+
+#include <gsl/deref_view.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+namespace
+{
+  // A node in a circular singly linked list. `optional_ref` is not measured
+  // here, as it cannot be rebound once constructed.
+  template <typename Policy>
+  struct node
+  {
+    node()
+    : next(Policy::make(*this))
+    {
+    }
+
+    node(node const&) = delete;
+    node& operator=(node const&) = delete;
+
+    typename Policy::template ref<node> next;
+    int value = {};
+  };
+
+  // Links the nodes in a random order so that each step is a dependent load
+  // the hardware prefetcher cannot predict.
+  template <typename Policy>
+  node<Policy> const& link_shuffled(std::vector<node<Policy>>& nodes)
+  {
+    std::vector<std::size_t> order(nodes.size());
+
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+      order[i] = i;
+      nodes[i].value = static_cast<int>(i);
+    }
+
+    std::shuffle(order.begin(), order.end(), std::mt19937(42));
+
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+      nodes[order[i]].next = Policy::make(nodes[order[(i + 1) % order.size()]]);
+    }
+
+    return nodes[order.front()];
+  }
+
+  template <typename Policy>
+  void linked_traversal(benchmark::State& state)
+  {
+    auto const count = static_cast<std::size_t>(state.range(0));
+    std::vector<node<Policy>> nodes(count);
+    node<Policy> const& head = link_shuffled(nodes);
+
+    for (auto _ : state)
+    {
+      node<Policy> const* n = &head;
+      int sum = 0;
+
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        sum += n->value;
+        n = Policy::address(n->next);
+      }
+
+      benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  struct payload
+  {
+    int value = {};
+    char padding[60];
+  };
+
+  // Reads a field through each element of a range of `retained`s that
+  // reference objects in a random order, prefetching `Distance` elements ahead.
+  template <std::size_t Distance>
+  void deref_traversal(benchmark::State& state)
+  {
+    auto const count = static_cast<std::size_t>(state.range(0));
+    std::vector<payload> objects(count);
+    std::vector<gsl::retained<payload>> refs;
+    refs.reserve(count);
+
+    for (auto& o : objects)
+    {
+      refs.push_back(gsl::make_retained(o));
+    }
+
+    std::shuffle(refs.begin(), refs.end(), std::mt19937(42));
+
+    for (auto _ : state)
+    {
+      int sum = 0;
+
+      for (auto const& o : gsl::prefetching<Distance>(refs))
+      {
+        sum += o.value;
+      }
+
+      benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+} // namespace
+
+BENCHMARK_TEMPLATE(deref_traversal, 0)->Range(1 << 8, 1 << 20);
+BENCHMARK_TEMPLATE(deref_traversal, 8)->Range(1 << 8, 1 << 20);
+BENCHMARK_TEMPLATE(deref_traversal, 16)->Range(1 << 8, 1 << 20);
+
+BENCHMARK_TEMPLATE(linked_traversal, bench::raw_pointer)->Range(1 << 8, 1 << 20);
+BENCHMARK_TEMPLATE(linked_traversal, bench::reference_wrapper)->Range(1 << 8, 1 << 20);
+BENCHMARK_TEMPLATE(linked_traversal, bench::not_null_pointer)->Range(1 << 8, 1 << 20);
+BENCHMARK_TEMPLATE(linked_traversal, bench::retained)->Range(1 << 8, 1 << 20);
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "callees.hpp"
+
+namespace bench
+{
+  int read_pointer(int const* p) noexcept
+  {
+    return p ? *p : 0;
+  }
+
+  int read_optional_ref(gsl::optional_ref<int const> o) noexcept
+  {
+    return o ? *o : 0;
+  }
+
+  int read_reference_wrapper(std::reference_wrapper<int const> r) noexcept
+  {
+    return r.get();
+  }
+
+  int read_not_null(not_null<int const*> p) noexcept
+  {
+    return *p;
+  }
+
+  int read_retained(gsl::retained<int const> r) noexcept
+  {
+    return *r;
+  }
+
+} // namespace bench
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GSL_BENCHMARKS_CALLEES_HPP
+#define GSL_BENCHMARKS_CALLEES_HPP
+
+#include "policies.hpp"
+
+#include <functional>
+
+// These functions are defined in a separate translation unit so that calls to
+// them cannot be inlined, exposing the cost of passing each kind of reference
+// across a function call boundary.
+namespace bench
+{
+  int read_pointer(int const* p) noexcept;
+  int read_optional_ref(gsl::optional_ref<int const> o) noexcept;
+  int read_reference_wrapper(std::reference_wrapper<int const> r) noexcept;
+  int read_not_null(not_null<int const*> p) noexcept;
+  int read_retained(gsl::retained<int const> r) noexcept;
+
+} // namespace bench
+
+#endif // GSL_BENCHMARKS_CALLEES_HPP
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GSL_BENCHMARKS_POLICIES_HPP
+#define GSL_BENCHMARKS_POLICIES_HPP
+
+#include <gsl/optional_ref.hpp>
+#include <gsl/retained.hpp>
+
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+
+namespace bench
+{
+  // A minimal stand-in for `gsl::not_null<T*>`, which checks for null on
+  // construction just as the GSL implementation does.
+  template <typename P>
+  class not_null
+  {
+  public:
+    explicit not_null(P ptr) noexcept
+    : m_ptr(ptr)
+    {
+      if (m_ptr == nullptr)
+      {
+        std::abort();
+      }
+    }
+
+    P get() const noexcept
+    {
+      return m_ptr;
+    }
+
+    decltype(auto) operator*() const noexcept
+    {
+      return *m_ptr;
+    }
+
+    P operator->() const noexcept
+    {
+      return m_ptr;
+    }
+
+  private:
+    P m_ptr;
+  };
+
+  // Each policy describes how to form a reference of the given kind to an
+  // object and how to recover the address of the referenced object.
+
+  struct raw_pointer
+  {
+    template <typename T>
+    using ref = T*;
+
+    template <typename T>
+    static T* make(T& t) noexcept
+    {
+      return std::addressof(t);
+    }
+
+    template <typename T>
+    static T const* address(T* r) noexcept
+    {
+      return r;
+    }
+  };
+
+  struct reference_wrapper
+  {
+    template <typename T>
+    using ref = std::reference_wrapper<T>;
+
+    template <typename T>
+    static std::reference_wrapper<T> make(T& t) noexcept
+    {
+      return std::ref(t);
+    }
+
+    template <typename T>
+    static T const* address(std::reference_wrapper<T> r) noexcept
+    {
+      return std::addressof(r.get());
+    }
+  };
+
+  struct not_null_pointer
+  {
+    template <typename T>
+    using ref = not_null<T*>;
+
+    template <typename T>
+    static not_null<T*> make(T& t) noexcept
+    {
+      return not_null<T*>(std::addressof(t));
+    }
+
+    template <typename T>
+    static T const* address(not_null<T*> r) noexcept
+    {
+      return r.get();
+    }
+  };
+
+  struct retained
+  {
+    template <typename T>
+    using ref = gsl::retained<T>;
+
+    template <typename T>
+    static gsl::retained<T> make(T& t) noexcept
+    {
+      return gsl::make_retained(t);
+    }
+
+    template <typename T>
+    static T const* address(gsl::retained<T> const& r) noexcept
+    {
+      return &*r;
+    }
+  };
+
+  struct optional_ref
+  {
+    template <typename T>
+    using ref = gsl::optional_ref<T>;
+
+    template <typename T>
+    static gsl::optional_ref<T> make(T& t) noexcept
+    {
+      return gsl::make_optional_ref(t);
+    }
+
+    template <typename T>
+    static T const* address(gsl::optional_ref<T> r) noexcept
+    {
+      return r ? &*r : nullptr;
+    }
+  };
+
+  // Orders and hashes references by address, for policies that have no
+  // suitable `std::less` or `std::hash` specialization of their own.
+  template <typename Policy, typename T>
+  struct address_less
+  {
+    bool operator()(
+        typename Policy::template ref<T> const& lhs,
+        typename Policy::template ref<T> const& rhs) const noexcept
+    {
+      return std::less<T const*>()(Policy::address(lhs), Policy::address(rhs));
+    }
+  };
+
+  template <typename Policy, typename T>
+  struct address_hash
+  {
+    std::size_t operator()(typename Policy::template ref<T> const& r) const noexcept
+    {
+      return std::hash<T const*>()(Policy::address(r));
+    }
+  };
+
+  template <typename Policy, typename T>
+  struct address_equal_to
+  {
+    bool operator()(
+        typename Policy::template ref<T> const& lhs,
+        typename Policy::template ref<T> const& rhs) const noexcept
+    {
+      return Policy::address(lhs) == Policy::address(rhs);
+    }
+  };
+
+  template <typename Policy, typename T>
+  struct container_traits
+  {
+    using less = address_less<Policy, T>;
+    using hash = address_hash<Policy, T>;
+    using equal_to = address_equal_to<Policy, T>;
+  };
+
+  // `retained` is measured through its own `std` specializations.
+  template <typename T>
+  struct container_traits<retained, T>
+  {
+    using less = std::less<gsl::retained<T>>;
+    using hash = std::hash<gsl::retained<T>>;
+    using equal_to = std::equal_to<gsl::retained<T>>;
+  };
+
+} // namespace bench
+
+#endif // GSL_BENCHMARKS_POLICIES_HPP
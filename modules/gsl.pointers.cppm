@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// The `gsl.pointers` module exports the reference types and their comparison,
+// hashing and relocation support. The headers are included in the global module
+// fragment, so translation units that mix `import gsl.pointers;` and
+// `#include <gsl/retained.hpp>` see the same entities.
+
+module;
+
+#include <gsl/contract.hpp>
+#include <gsl/contract_handler.hpp>
+#include <gsl/optional_ref.hpp>
+#include <gsl/optional_retained.hpp>
+#include <gsl/relocatable.hpp>
+#include <gsl/retained.hpp>
+
+export module gsl.pointers;
+
+export namespace gsl
+{
+  using gsl::contract_violation_handler;
+  using gsl::get_contract_violation_handler;
+  using gsl::set_contract_violation_handler;
+
+  using gsl::is_nothrow_relocatable_v;
+  using gsl::is_trivially_relocatable;
+  using gsl::is_trivially_relocatable_v;
+  using gsl::relocate_at;
+  using gsl::uninitialized_relocate;
+  using gsl::uninitialized_relocate_backward;
+
+  using gsl::as_pointers;
+  using gsl::as_retained;
+  using gsl::as_retained_unchecked;
+  using gsl::make_retained;
+  using gsl::retained;
+  using gsl::retained_hash;
+
+  using gsl::optional_retained;
+
+  using gsl::as_optional_refs;
+  using gsl::identity_equal_to;
+  using gsl::identity_hash;
+  using gsl::identity_less;
+  using gsl::make_optional_ref;
+  using gsl::optional_ref;
+
+  using gsl::swap;
+
+  using gsl::operator==;
+  using gsl::operator!=;
+#if defined(GSL_POINTERS_THREE_WAY_COMPARISON)
+  using gsl::operator<=>;
+#else
+  using gsl::operator<;
+  using gsl::operator<=;
+  using gsl::operator>;
+  using gsl::operator>=;
+#endif
+} // namespace gsl
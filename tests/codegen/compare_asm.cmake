@@ -0,0 +1,92 @@
+# Compares the instructions in two assembly files, ignoring assembler
+# directives, local labels and comments, which differ between otherwise
+# identical translation units.
+#
+# The operands of a register-register comparison are sorted when it is
+# immediately followed by an equality test (je, jne, sete or setne, or their z
+# forms), for which the order does not matter. GCC orders the operands of an
+# equality comparison by SSA name, which differs between a pointer and a struct
+# holding one, although the instructions are otherwise the same. Comparisons
+# followed by anything else, such as jl or setg, are compared exactly.
+#
+# Usage: cmake -DWRAPPED=<file> -DRAW=<file> [-DSTAMP=<file>] -P compare_asm.cmake
+
+function(read_instructions path out)
+  file(STRINGS "${path}" lines)
+  set(instructions)
+
+  foreach(line IN LISTS lines)
+    string(REGEX REPLACE "[ \t]+(#|//) .*$" "" line "${line}")
+    string(STRIP "${line}" line)
+
+    if(line STREQUAL "" OR line MATCHES "^[.#@;]" OR line MATCHES "^//")
+      continue()
+    endif()
+
+    string(REGEX REPLACE "[ \t]+" " " line "${line}")
+    list(APPEND instructions "${line}")
+  endforeach()
+
+  list(LENGTH instructions length)
+  set(index 1)
+
+  while(index LESS length)
+    math(EXPR previous "${index} - 1")
+    list(GET instructions ${previous} compare)
+    list(GET instructions ${index} consumer)
+
+    # Each match overwrites CMAKE_MATCH_<n>, so the comparison is matched last.
+    if(consumer MATCHES "^(je|jne|jz|jnz|sete|setne|setz|setnz) "
+       AND compare MATCHES "^(cmp[a-z]*) (%[a-z0-9]+), (%[a-z0-9]+)$")
+      set(mnemonic "${CMAKE_MATCH_1}")
+      set(first "${CMAKE_MATCH_2}")
+      set(second "${CMAKE_MATCH_3}")
+
+      if(second STRLESS first)
+        list(REMOVE_AT instructions ${previous})
+        list(INSERT instructions ${previous} "${mnemonic} ${second}, ${first}")
+      endif()
+    endif()
+
+    math(EXPR index "${index} + 1")
+  endwhile()
+
+  set(${out} "${instructions}" PARENT_SCOPE)
+endfunction()
+
+read_instructions("${WRAPPED}" wrapped)
+read_instructions("${RAW}" raw)
+
+list(LENGTH wrapped wrapped_length)
+list(LENGTH raw raw_length)
+
+if(wrapped_length EQUAL 0)
+  message(FATAL_ERROR "no instructions found in ${WRAPPED}")
+endif()
+
+set(index 0)
+
+while(index LESS wrapped_length AND index LESS raw_length)
+  list(GET wrapped ${index} wrapped_line)
+  list(GET raw ${index} raw_line)
+
+  if(NOT wrapped_line STREQUAL raw_line)
+    message(FATAL_ERROR
+      "generated code differs at instruction ${index}:\n"
+      "  wrapped: ${wrapped_line}\n"
+      "  raw:     ${raw_line}\n"
+      "see ${WRAPPED} and ${RAW}")
+  endif()
+
+  math(EXPR index "${index} + 1")
+endwhile()
+
+if(NOT wrapped_length EQUAL raw_length)
+  message(FATAL_ERROR
+    "generated code differs in length (${wrapped_length} and ${raw_length} "
+    "instructions); see ${WRAPPED} and ${RAW}")
+endif()
+
+if(DEFINED STAMP)
+  file(TOUCH "${STAMP}")
+endif()
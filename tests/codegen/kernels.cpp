@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Each kernel is compiled twice, once using the reference types and once using
+// the raw pointers they replace, and the generated code must be identical. The
+// kernels have C linkage so that both versions have the same symbol names.
+
+#include <cstddef>
+
+#if defined(GSL_POINTERS_CODEGEN_WRAPPED)
+
+#include <gsl/optional_ref.hpp>
+#include <gsl/retained.hpp>
+#include <gsl/retained_restrict.hpp>
+#include <gsl/retained_span.hpp>
+
+#include <type_traits>
+
+namespace
+{
+  // Without these properties the types are not passed and returned in
+  // registers like `T*`.
+  template <typename R, typename T>
+  constexpr bool is_pointer_abi_v = std::is_trivially_move_constructible_v<R>
+      && std::is_trivially_destructible_v<R> && sizeof(R) == sizeof(T*)
+      && alignof(R) == alignof(T*);
+
+  static_assert(std::is_trivially_copyable_v<gsl::retained<int>>);
+  static_assert(is_pointer_abi_v<gsl::retained<int>, int>);
+  static_assert(is_pointer_abi_v<gsl::retained<int const>, int const>);
+
+  static_assert(std::is_trivially_copyable_v<gsl::optional_ref<int>>);
+  static_assert(std::is_trivially_copy_constructible_v<gsl::optional_ref<int>>);
+  static_assert(is_pointer_abi_v<gsl::optional_ref<int>, int>);
+  static_assert(is_pointer_abi_v<gsl::optional_ref<int const>, int const>);
+
+  static_assert(std::is_trivially_copyable_v<gsl::retained_span<int>>);
+  static_assert(std::is_trivially_destructible_v<gsl::retained_span<int>>);
+  static_assert(sizeof(gsl::retained_span<int>) == 2 * sizeof(int*));
+
+  static_assert(is_pointer_abi_v<gsl::retained_restrict<int>, int>);
+  static_assert(is_pointer_abi_v<gsl::retained_restrict<int const>, int const>);
+} // namespace
+
+using int_ref = gsl::retained<int>;
+using int_cref = gsl::retained<int const>;
+using int_opt = gsl::optional_ref<int>;
+using int_copt = gsl::optional_ref<int const>;
+using int_cspan = gsl::retained_span<int const>;
+using int_restrict = gsl::retained_restrict<int>;
+using int_crestrict = gsl::retained_restrict<int const>;
+
+#define GSL_CODEGEN_GET(r) (&*(r))
+#define GSL_CODEGEN_VALUE_OR(o, d) ((o).value_or(d))
+#define GSL_CODEGEN_ENGAGED(o) ((o).has_value())
+
+#else
+
+using int_ref = int*;
+using int_cref = int const*;
+using int_opt = int*;
+using int_copt = int const*;
+using int_restrict = int* __restrict__;
+using int_crestrict = int const* __restrict__;
+
+#define GSL_CODEGEN_GET(r) (r)
+#define GSL_CODEGEN_VALUE_OR(o, d) ((o) != nullptr ? *(o) : (d))
+#define GSL_CODEGEN_ENGAGED(o) ((o) != nullptr)
+
+#endif
+
+struct point
+{
+  int x;
+  int y;
+};
+
+extern "C"
+{
+  int codegen_load(int_cref r) noexcept
+  {
+    return *r;
+  }
+
+  void codegen_store(int_ref r, int value) noexcept
+  {
+    *r = value;
+  }
+
+  int_ref codegen_forward(int_ref r) noexcept
+  {
+    return r;
+  }
+
+  bool codegen_same(int_cref a, int_cref b) noexcept
+  {
+    return a == b;
+  }
+
+#if defined(GSL_POINTERS_CODEGEN_WRAPPED)
+  int codegen_member(gsl::retained<point const> p) noexcept
+  {
+    return p->y;
+  }
+#else
+  int codegen_member(point const* p) noexcept
+  {
+    return p->y;
+  }
+#endif
+
+  int codegen_sum(int_cref const* rs, std::size_t n) noexcept
+  {
+    int total = 0;
+
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      total += *GSL_CODEGEN_GET(rs[i]);
+    }
+
+    return total;
+  }
+
+  bool codegen_engaged(int_copt o) noexcept
+  {
+    return GSL_CODEGEN_ENGAGED(o);
+  }
+
+  int codegen_value_or(int_copt o, int fallback) noexcept
+  {
+    return GSL_CODEGEN_VALUE_OR(o, fallback);
+  }
+
+  void codegen_increment_if(int_opt o) noexcept
+  {
+    if (GSL_CODEGEN_ENGAGED(o))
+    {
+      ++*o;
+    }
+  }
+
+  // Clang does not apply `restrict` to the members of parameters. With it,
+  // `*value` is not reloaded after `*total` is stored.
+#if !defined(__clang__)
+  void codegen_restrict_accumulate(int_restrict total, int_crestrict value) noexcept
+  {
+    *total += *value;
+    *total += *value;
+  }
+#endif
+
+#if defined(GSL_POINTERS_CODEGEN_WRAPPED)
+  int codegen_span_sum(int_cspan s) noexcept
+  {
+    int total = 0;
+
+    for (int const i : s)
+    {
+      total += i;
+    }
+
+    return total;
+  }
+#else
+  int codegen_span_sum(int const* data, std::size_t size) noexcept
+  {
+    int total = 0;
+
+    int const* const end = data + size;
+
+    for (int const* i = data; i != end; ++i)
+    {
+      total += *i;
+    }
+
+    return total;
+  }
+#endif
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <catch2/catch.hpp>
+
+#include <gsl/aligned_retained.hpp>
+
+#include <type_traits>
+#include <utility>
+
+using gsl::aligned_retained;
+using gsl::make_retained;
+using gsl::make_retained_aligned;
+
+namespace
+{
+  struct alignas(64) block
+  {
+    float values[16] = {};
+  };
+} // namespace
+
+SCENARIO("`aligned_retained` is a move-only reference")
+{
+  CHECK(std::is_trivially_move_constructible_v<aligned_retained<block, 64>>);
+  CHECK(!std::is_copy_constructible_v<aligned_retained<block, 64>>);
+  CHECK(!std::is_constructible_v<aligned_retained<block, 64>, block&&>);
+  CHECK(gsl::is_trivially_relocatable_v<aligned_retained<block, 64>>);
+  CHECK(sizeof(aligned_retained<block, 64>) == sizeof(block*));
+}
+
+SCENARIO("`aligned_retained`'s exception specifications do not depend on the checks")
+{
+  // Only moves, which are never checked, are `noexcept`.
+  CHECK(!std::is_nothrow_constructible_v<aligned_retained<block, 64>, block&>);
+  CHECK(!std::is_nothrow_constructible_v<
+        aligned_retained<block, 64>,
+        gsl::retained<block>&&>);
+  CHECK(!noexcept(make_retained_aligned<64>(std::declval<block&>())));
+  CHECK(std::is_nothrow_move_constructible_v<aligned_retained<block, 64>>);
+}
+
+SCENARIO("`aligned_retained` can be converted to weaker alignments")
+{
+  using float_16 = aligned_retained<float, 16>;
+  using float_64 = aligned_retained<float, 64>;
+
+  CHECK(std::is_constructible_v<float_16, float_64&&>);
+  CHECK(std::is_constructible_v<aligned_retained<float const, 64>, float_64&&>);
+  CHECK(!std::is_constructible_v<float_64, float_16&&>);
+}
+
+SCENARIO("`aligned_retained` can be used to access the objects it references")
+{
+  GIVEN("an aligned object")
+  {
+    block b;
+    b.values[3] = 1.0f;
+
+    WHEN("an `aligned_retained` is created with `make_retained_aligned`")
+    {
+      auto r = make_retained_aligned<64>(b);
+      auto const& cr = r;
+
+      THEN("the object can be accessed")
+      {
+        CHECK(decltype(r)::alignment == 64);
+        CHECK(r.get() == &b);
+        CHECK(cr.get() == &b);
+        CHECK(r->values[3] == 1.0f);
+        CHECK(&*cr == &b);
+        CHECK(static_cast<block const*>(cr) == &b);
+      }
+
+      THEN("it can be converted to a weaker alignment")
+      {
+        aligned_retained<block const, 64> c = std::move(r);
+        aligned_retained<float, 16> f(b.values[0]);
+        aligned_retained<float, 4> w = std::move(f);
+
+        CHECK(c.get() == &b);
+        CHECK(w.get() == &b.values[0]);
+      }
+    }
+
+    WHEN("an `aligned_retained` is created from a `retained`")
+    {
+      aligned_retained<block, 64> r(make_retained(b));
+      aligned_retained<block, 64> s(make_retained(b));
+
+      THEN("it references the same object")
+      {
+        CHECK(r.get() == &b);
+        CHECK(r == s);
+      }
+    }
+  }
+}
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Poisoning is enabled regardless of `NDEBUG` so that it can be tested.
+#define GSL_POINTERS_ARENA_POISON 1
+
+#include <catch2/catch.hpp>
+
+#include <gsl/arena.hpp>
+
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+using gsl::retained;
+
+namespace
+{
+  struct node
+  {
+    node(std::vector<int>& order, int id)
+    : order(order)
+    , id(id)
+    {
+    }
+
+    ~node()
+    {
+      order.push_back(id);
+    }
+
+    std::vector<int>& order;
+    int id;
+  };
+
+  struct alignas(64) wide
+  {
+    unsigned char bytes[64];
+  };
+
+  // Counts the allocations made through it.
+  class counting_resource : public std::pmr::memory_resource
+  {
+  public:
+    int allocations = 0;
+    int deallocations = 0;
+
+  private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+      ++allocations;
+      return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+    {
+      ++deallocations;
+      std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override
+    {
+      return this == &other;
+    }
+  };
+} // namespace
+
+SCENARIO("objects can be created in an `arena`")
+{
+  GIVEN("an arena")
+  {
+    std::vector<int> order;
+    counting_resource upstream;
+
+    WHEN("objects are created and the arena destroyed")
+    {
+      {
+        gsl::arena a(256, &upstream);
+        retained<node> first = a.make<node>(order, 1);
+        retained<node> second = a.make<node>(order, 2);
+        retained<int> i = a.make<int>(3);
+
+        CHECK(first->id == 1);
+        CHECK(second->id == 2);
+        CHECK(*i == 3);
+        CHECK(order.empty());
+      }
+
+      THEN("the objects are destroyed in reverse order and the memory is freed")
+      {
+        CHECK(order == std::vector<int>{2, 1});
+        CHECK(upstream.allocations == 1);
+        CHECK(upstream.deallocations == 1);
+      }
+    }
+
+    WHEN("objects larger than a block and with extended alignment are created")
+    {
+      gsl::arena a(256, &upstream);
+      retained<wide> w = a.make<wide>();
+      std::vector<retained<wide>> ws;
+
+      for (int n = 0; n < 10; ++n)
+      {
+        ws.push_back(a.make<wide>());
+      }
+
+      THEN("they are correctly aligned")
+      {
+        CHECK(reinterpret_cast<std::uintptr_t>(&*w) % 64 == 0);
+
+        for (auto const& r : ws)
+        {
+          CHECK(reinterpret_cast<std::uintptr_t>(&*r) % 64 == 0);
+        }
+
+        CHECK(upstream.allocations > 1);
+      }
+    }
+  }
+}
+
+SCENARIO("an `arena` can be reset and reused")
+{
+  GIVEN("an arena that has been used")
+  {
+    std::vector<int> order;
+    counting_resource upstream;
+    gsl::arena a(256, &upstream);
+
+    for (int n = 0; n < 20; ++n)
+    {
+      a.make<node>(order, n);
+    }
+
+    auto const allocations = upstream.allocations;
+    auto* const bytes = static_cast<unsigned char*>(a.allocate(16, 1));
+    std::memset(bytes, 0, 16);
+
+    WHEN("it is reset")
+    {
+      a.reset();
+
+      THEN("the objects are destroyed and the memory is poisoned")
+      {
+        CHECK(order.size() == 20);
+        CHECK(order.front() == 19);
+        CHECK(upstream.deallocations == 0);
+
+#if !defined(GSL_POINTERS_ASAN)
+        CHECK(bytes[0] == gsl::arena::poison_byte);
+        CHECK(bytes[15] == gsl::arena::poison_byte);
+#endif
+      }
+
+      AND_WHEN("it is used again")
+      {
+        for (int n = 0; n < 20; ++n)
+        {
+          a.make<node>(order, n);
+        }
+
+        THEN("the existing blocks are reused")
+        {
+          CHECK(upstream.allocations == allocations);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("an `arena` can be used as a polymorphic memory resource")
+{
+  GIVEN("a `pmr::vector` using an arena")
+  {
+    gsl::arena a;
+    std::pmr::vector<std::pmr::string> strings(&a);
+
+    WHEN("elements are added")
+    {
+      for (int n = 0; n < 100; ++n)
+      {
+        strings.emplace_back(std::string(40, 'x'));
+      }
+
+      THEN("they are allocated from the arena")
+      {
+        CHECK(strings.size() == 100);
+        CHECK(strings.back().get_allocator().resource() == &a);
+        CHECK(a.is_equal(a));
+        CHECK(!a.is_equal(*std::pmr::new_delete_resource()));
+      }
+    }
+  }
+}
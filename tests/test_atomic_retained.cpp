@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <catch2/catch.hpp>
+
+#include <gsl/atomic_retained.hpp>
+
+#include <array>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using gsl::atomic_retained;
+using gsl::make_retained;
+using gsl::retained;
+
+namespace
+{
+  struct config
+  {
+    int version = {};
+  };
+
+} // namespace
+
+SCENARIO("`atomic_retained` is always lock-free")
+{
+  CHECK(atomic_retained<int>::is_always_lock_free);
+  CHECK(atomic_retained<config const>::is_always_lock_free);
+
+  int i = {};
+  atomic_retained<int> a(make_retained(i));
+
+  CHECK(a.is_lock_free());
+}
+
+SCENARIO("`atomic_retained` cannot be copied")
+{
+  CHECK_FALSE(std::is_copy_constructible_v<atomic_retained<int>>);
+  CHECK_FALSE(std::is_copy_assignable_v<atomic_retained<int>>);
+}
+
+SCENARIO("`atomic_retained` cannot be constructed from temporaries")
+{
+  CHECK(std::is_constructible_v<atomic_retained<int const>, retained<int const>>);
+  CHECK_FALSE(std::is_constructible_v<atomic_retained<int const>, int&&>);
+  CHECK_FALSE(std::is_constructible_v<atomic_retained<int const>, int const*>);
+}
+
+SCENARIO("`atomic_retained` can be loaded and stored")
+{
+  int i = {};
+  int j = {};
+
+  GIVEN("an `atomic_retained` constructed from a `retained`")
+  {
+    atomic_retained<int> a(make_retained(i));
+
+    REQUIRE(a.load() == make_retained(i));
+    REQUIRE(a.load(std::memory_order_acquire) == make_retained(i));
+
+    WHEN("it is stored a `retained`")
+    {
+      a.store(make_retained(j), std::memory_order_release);
+
+      REQUIRE(a.load() == make_retained(j));
+    }
+
+    WHEN("it is exchanged with a `retained`")
+    {
+      retained<int> r = a.exchange(make_retained(j), std::memory_order_acq_rel);
+
+      REQUIRE(r == make_retained(i));
+      REQUIRE(a.load() == make_retained(j));
+    }
+  }
+}
+
+SCENARIO("`atomic_retained` maintains const-correctness")
+{
+  int i = {};
+
+  atomic_retained<int> a(make_retained(i));
+  atomic_retained<int> const& c = a;
+
+  CHECK(std::is_same_v<decltype(a.load()), retained<int>>);
+  CHECK(std::is_same_v<decltype(c.load()), retained<int const>>);
+}
+
+SCENARIO("`atomic_retained` supports compare-and-exchange")
+{
+  int i = {};
+  int j = {};
+  int k = {};
+
+  atomic_retained<int> a(make_retained(i));
+
+  GIVEN("an expected value that matches")
+  {
+    retained<int> expected = make_retained(i);
+
+    REQUIRE(a.compare_exchange_strong(expected, make_retained(j)));
+    REQUIRE(expected == make_retained(i));
+    REQUIRE(a.load() == make_retained(j));
+  }
+
+  GIVEN("an expected value that does not match")
+  {
+    retained<int> expected = make_retained(k);
+
+    REQUIRE_FALSE(a.compare_exchange_strong(
+        expected, make_retained(j), std::memory_order_acq_rel, std::memory_order_acquire));
+    REQUIRE(expected == make_retained(i));
+    REQUIRE(a.load() == make_retained(i));
+  }
+
+  GIVEN("a weak compare-and-exchange loop")
+  {
+    retained<int> expected = a.load(std::memory_order_relaxed);
+
+    while (!a.compare_exchange_weak(expected, make_retained(k)))
+    {
+    }
+
+    REQUIRE(a.load() == make_retained(k));
+  }
+}
+
+SCENARIO("`atomic_retained` can be used to publish objects to other threads")
+{
+  std::array<config, 2> configs = {config{1}, config{2}};
+  atomic_retained<config const> current(make_retained(configs[0]));
+  std::atomic<bool> done = {false};
+  std::atomic<bool> valid = {true};
+
+  std::vector<std::thread> readers;
+
+  for (int t = 0; t < 2; ++t)
+  {
+    readers.emplace_back([&] {
+      while (!done.load(std::memory_order_acquire))
+      {
+        int version = current.load(std::memory_order_acquire)->version;
+
+        if (version != 1 && version != 2)
+        {
+          valid.store(false);
+        }
+      }
+    });
+  }
+
+  for (int n = 0; n < 1000; ++n)
+  {
+    current.store(make_retained(configs[n % 2]), std::memory_order_release);
+  }
+
+  done.store(true, std::memory_order_release);
+
+  for (auto& reader : readers)
+  {
+    reader.join();
+  }
+
+  REQUIRE(valid.load());
+}
@@ -0,0 +1,392 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// These tests are built with `GSL_POINTERS_CONTRACT_MODE` set to
+// `GSL_POINTERS_CONTRACT_HANDLER`, with `GSL_POINTERS_HARDENED` defined and with
+// `GSL_POINTERS_RESTRICT_CHECKS` and `GSL_POINTERS_ALIGNMENT_CHECKS` enabled.
+
+#include <catch2/catch.hpp>
+
+#include <gsl/aligned_retained.hpp>
+#include <gsl/epoch.hpp>
+#include <gsl/gather.hpp>
+#include <gsl/optional_ref.hpp>
+#include <gsl/optional_retained.hpp>
+#include <gsl/retained.hpp>
+#include <gsl/retained_offset.hpp>
+#include <gsl/retained_restrict.hpp>
+#include <gsl/retained_span.hpp>
+#include <gsl/tagged_retained.hpp>
+
+#include <array>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <vector>
+
+#if GSL_POINTERS_CONTRACT_MODE != GSL_POINTERS_CONTRACT_HANDLER \
+    || !defined(GSL_POINTERS_HARDENED) || !GSL_POINTERS_RESTRICT_CHECKS \
+    || !GSL_POINTERS_ALIGNMENT_CHECKS
+#error "test_contract.cpp must be built in hardened handler mode"
+#endif
+
+using gsl::optional_ref;
+
+namespace
+{
+  struct violation
+  {
+    std::string message;
+  };
+
+  void throw_violation(char const* message)
+  {
+    throw violation{message};
+  }
+
+  struct scoped_handler
+  {
+    scoped_handler()
+    : previous(gsl::set_contract_violation_handler(&throw_violation))
+    {
+    }
+
+    ~scoped_handler()
+    {
+      gsl::set_contract_violation_handler(previous);
+    }
+
+    gsl::contract_violation_handler previous;
+  };
+
+  template <typename F>
+  std::string violation_message(F f)
+  {
+    try
+    {
+      f();
+    }
+    catch (violation const& v)
+    {
+      return v.message;
+    }
+
+    return {};
+  }
+} // namespace
+
+SCENARIO("contract violation handlers can be installed")
+{
+  GIVEN("no handler")
+  {
+    REQUIRE(gsl::get_contract_violation_handler() == nullptr);
+
+    WHEN("a handler is installed")
+    {
+      auto const previous = gsl::set_contract_violation_handler(&throw_violation);
+
+      THEN("the previous handler is returned")
+      {
+        CHECK(previous == nullptr);
+        CHECK(gsl::get_contract_violation_handler() == &throw_violation);
+      }
+
+      gsl::set_contract_violation_handler(previous);
+    }
+  }
+}
+
+SCENARIO("contract violations are reported to the handler")
+{
+  scoped_handler handler;
+
+  GIVEN("a disengaged `optional_ref`")
+  {
+    optional_ref<int> o;
+
+    THEN("accessing its value is reported")
+    {
+      CHECK(violation_message([&] { o.value(); }) == "bad optional access");
+    }
+
+    THEN("dereferencing it is reported")
+    {
+      CHECK(violation_message([&] { *o; }) == "dereference of a disengaged optional");
+      CHECK(violation_message([&] { o.operator->(); }) != "");
+    }
+  }
+
+  GIVEN("an engaged `optional_ref`")
+  {
+    int i = 1;
+    optional_ref<int> o = i;
+
+    THEN("accessing its value is not reported")
+    {
+      CHECK(&o.value() == &i);
+      CHECK(&*o == &i);
+    }
+  }
+
+  GIVEN("a disengaged `optional_retained` and `optional_retained_offset`")
+  {
+    gsl::optional_retained<int> r;
+    gsl::optional_retained_offset<int> ro;
+
+    THEN("accessing their values is reported")
+    {
+      CHECK(violation_message([&] { r.value(); }) == "bad optional access");
+      CHECK(violation_message([&] { ro.value(); }) == "bad optional access");
+    }
+  }
+}
+
+SCENARIO("overlapping `retained_restrict`s are reported to the handler")
+{
+  scoped_handler handler;
+
+  GIVEN("a buffer referenced by a writable `retained_restrict`")
+  {
+    float buffer[8] = {};
+    gsl::retained_restrict<float> out(buffer[0]);
+    gsl::retained_restrict<float const> in(buffer[4]);
+
+    THEN("registering an overlapping range is reported")
+    {
+      gsl::restrict_scope scope;
+      scope.add(out, 8);
+
+      CHECK(
+          violation_message([&] { scope.add(in, 2); })
+          == "overlapping restrict references");
+    }
+
+    THEN("registering a disjoint range is not reported")
+    {
+      gsl::restrict_scope scope;
+      scope.add(out, 4);
+
+      CHECK(violation_message([&] { scope.add(in, 4); }) == "");
+    }
+  }
+}
+
+SCENARIO("null pointers viewed as `retained`s are reported to the handler")
+{
+  scoped_handler handler;
+
+  GIVEN("an array of pointers containing a null pointer")
+  {
+    int i = {};
+    int* ptrs[3] = {&i, nullptr, &i};
+
+    THEN("viewing the array as `retained`s is reported")
+    {
+      CHECK(
+          violation_message([&] { gsl::as_retained(ptrs, 3); })
+          == "null pointer viewed as a retained");
+    }
+
+    THEN("viewing only the non-null prefix is not reported")
+    {
+      CHECK(violation_message([&] { gsl::as_retained(ptrs, 1); }) == "");
+    }
+  }
+}
+
+SCENARIO("out-of-range `retained_offset`s are reported to the handler")
+{
+  scoped_handler handler;
+
+  GIVEN("a buffer larger than a 16-bit offset can span")
+  {
+    using short_offset = gsl::retained_offset<char, std::int16_t>;
+
+    std::vector<char> buffer(1 << 20);
+
+    auto const target = new (&buffer.front()) char();
+    void* const holder = &buffer[buffer.size() - 64];
+
+    THEN("referencing an object out of range is reported")
+    {
+      CHECK(
+          violation_message([&] { new (holder) short_offset(*target); })
+          == "object is out of range of the offset type");
+    }
+
+    THEN("referencing an object in range is not reported")
+    {
+      auto& in_range = buffer[buffer.size() - 128];
+
+      CHECK(violation_message([&] { new (holder) short_offset(in_range); }) == "");
+    }
+  }
+}
+
+SCENARIO("misaligned `aligned_retained`s are reported to the handler")
+{
+  scoped_handler handler;
+
+  GIVEN("an object with a known alignment")
+  {
+    alignas(16) float values[8] = {};
+
+    THEN("referencing a misaligned element is reported")
+    {
+      CHECK(
+          violation_message([&] { gsl::make_retained_aligned<16>(values[1]); })
+          == "object is not sufficiently aligned");
+    }
+
+    THEN("referencing an aligned element is not reported")
+    {
+      CHECK(violation_message([&] { gsl::make_retained_aligned<16>(values[4]); }) == "");
+    }
+  }
+}
+
+SCENARIO("out-of-range tags are reported to the handler")
+{
+  scoped_handler handler;
+
+  GIVEN("a `tagged_retained` with two tag bits")
+  {
+    struct alignas(4) word
+    {
+      char value;
+    };
+
+    word w = {};
+    gsl::tagged_retained<word, 2> t(w);
+
+    THEN("constructing with a tag that does not fit is reported")
+    {
+      CHECK(
+          violation_message([&] { gsl::tagged_retained<word, 2>(w, 4); })
+          == "tag is out of range");
+      CHECK(violation_message([&] { gsl::tagged_retained<word, 2>(w, 3); }) == "");
+    }
+
+    THEN("setting a tag that does not fit is reported")
+    {
+      CHECK(violation_message([&] { t.set_tag(4); }) == "tag is out of range");
+      CHECK(violation_message([&] { t.fetch_or_tag(8); }) == "tag is out of range");
+      CHECK(violation_message([&] { t.fetch_and_tag(5); }) == "tag is out of range");
+      CHECK(t.tag() == 0);
+      CHECK(t.get() == &w);
+    }
+  }
+}
+
+SCENARIO("out-of-bounds `retained_span` accesses are reported to the handler")
+{
+  scoped_handler handler;
+
+  GIVEN("a `retained_span` to an array")
+  {
+    int values[4] = {};
+    gsl::retained_span<int> s(values);
+
+    THEN("indexing past the end is reported")
+    {
+      CHECK(violation_message([&] { s[4]; }) == "access out of bounds");
+      CHECK(violation_message([&] { s[3]; }) == "");
+    }
+
+    THEN("taking a subrange past the end is reported")
+    {
+      CHECK(violation_message([&] { s.first(5); }) == "access out of bounds");
+      CHECK(violation_message([&] { s.subspan(2, 3); }) == "access out of bounds");
+      CHECK(violation_message([&] { s.subspan(4); }) == "");
+    }
+
+    THEN("accessing the ends of an empty subrange is reported")
+    {
+      CHECK(violation_message([&] { s.last(0).front(); }) == "access out of bounds");
+    }
+  }
+}
+
+SCENARIO("gathers into output ranges that are too small are reported to the handler")
+{
+  scoped_handler handler;
+
+  GIVEN("an array of `retained`")
+  {
+    struct sample
+    {
+      float value;
+    };
+
+    sample samples[2] = {{1.0f}, {2.0f}};
+    std::array<gsl::retained<sample>, 2> refs = {
+        gsl::make_retained(samples[0]), gsl::make_retained(samples[1])};
+
+    THEN("gathering into a smaller array is reported")
+    {
+      std::array<float, 1> out = {};
+
+      CHECK(
+          violation_message([&] { gsl::gather(refs, &sample::value, out); })
+          == "access out of bounds");
+    }
+
+    THEN("gathering into an array of the same size is not reported")
+    {
+      std::array<float, 2> out = {};
+
+      CHECK(violation_message([&] { gsl::gather(refs, &sample::value, out); }) == "");
+      CHECK(out[1] == 2.0f);
+    }
+  }
+}
+
+SCENARIO("loads through guards of other epoch domains are reported to the handler")
+{
+  scoped_handler handler;
+
+  GIVEN("a `guarded_retained` and guards of two domains")
+  {
+    int i = 0;
+    gsl::epoch_domain domain;
+    gsl::epoch_domain other;
+    gsl::guarded_retained<int> ref(domain, gsl::make_retained(i));
+    gsl::epoch_domain::participant participant(domain);
+    gsl::epoch_domain::participant other_participant(other);
+
+    THEN("loading with a guard of the other domain is reported")
+    {
+      auto const guard = other_participant.pin();
+
+      CHECK(
+          violation_message([&] { ref.load(guard); })
+          == "guard pins a different epoch domain");
+    }
+
+    THEN("loading with a guard of its own domain is not reported")
+    {
+      auto const guard = participant.pin();
+
+      CHECK(violation_message([&] { ref.load(guard); }) == "");
+    }
+  }
+}
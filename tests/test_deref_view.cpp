@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <catch2/catch.hpp>
+
+#include <gsl/deref_view.hpp>
+
+#include <array>
+#include <list>
+#include <numeric>
+#include <vector>
+
+using gsl::make_optional_ref;
+using gsl::make_retained;
+using gsl::optional_ref;
+using gsl::retained;
+
+namespace
+{
+  struct node
+  {
+    int value = {};
+  };
+
+  struct tuned
+  {
+    int value = {};
+  };
+
+  template <typename Range, typename = void>
+  struct can_deref : std::false_type
+  {
+  };
+
+  template <typename Range>
+  struct can_deref<Range, std::void_t<decltype(gsl::deref(std::declval<Range>()))>>
+  : std::true_type
+  {
+  };
+
+} // namespace
+
+template <>
+struct gsl::prefetch_distance<tuned> : std::integral_constant<std::size_t, 4>
+{
+};
+
+SCENARIO("`deref` yields the objects referenced by a range of `retained`s")
+{
+  std::array<node, 3> nodes = {node{1}, node{2}, node{3}};
+  std::vector<retained<node>> refs;
+
+  for (auto& n : nodes)
+  {
+    refs.push_back(make_retained(n));
+  }
+
+  GIVEN("a `deref` view of a mutable range")
+  {
+    auto view = gsl::deref(refs);
+
+    CHECK(std::is_same_v<decltype(*view.begin()), node&>);
+
+    for (auto& n : view)
+    {
+      n.value *= 10;
+    }
+
+    CHECK(nodes[0].value == 10);
+    CHECK(nodes[1].value == 20);
+    CHECK(nodes[2].value == 30);
+  }
+
+  GIVEN("a `deref` view of a read-only range")
+  {
+    auto view = gsl::deref(std::as_const(refs));
+
+    CHECK(std::is_same_v<decltype(*view.begin()), node const&>);
+
+    int sum = 0;
+
+    for (auto const& n : view)
+    {
+      sum += n.value;
+    }
+
+    CHECK(sum == 6);
+  }
+
+  GIVEN("a `deref` view of a range that is not random access")
+  {
+    std::list<retained<node>> list;
+    list.push_back(make_retained(nodes[2]));
+
+    auto view = gsl::deref(list);
+
+    CHECK(&*view.begin() == &nodes[2]);
+    CHECK(std::next(view.begin()) == view.end());
+  }
+}
+
+SCENARIO("`deref` skips disengaged references")
+{
+  std::array<int, 3> i = {1, 2, 3};
+
+  GIVEN("a range of `optional_ref`s")
+  {
+    std::vector<optional_ref<int>> refs = {
+        std::nullopt, i[0], std::nullopt, std::nullopt, i[1], i[2], std::nullopt};
+
+    std::vector<int*> seen;
+
+    for (auto& n : gsl::deref(refs))
+    {
+      seen.push_back(&n);
+    }
+
+    CHECK(seen == std::vector<int*>{&i[0], &i[1], &i[2]});
+  }
+
+  GIVEN("a range of pointers")
+  {
+    std::vector<int const*> ptrs = {&i[2], nullptr, &i[0]};
+
+    auto view = gsl::prefetching<2>(ptrs);
+
+    CHECK(std::accumulate(view.begin(), view.end(), 0) == 4);
+  }
+
+  GIVEN("a range of only disengaged `optional_ref`s")
+  {
+    std::vector<optional_ref<int>> refs(4);
+
+    auto view = gsl::deref(refs);
+
+    CHECK(view.begin() == view.end());
+  }
+}
+
+SCENARIO("`deref` prefetches as configured by `prefetch_distance`")
+{
+  CHECK(gsl::prefetch_distance_v<node> == 0);
+  CHECK(gsl::prefetch_distance_v<tuned> == 4);
+
+  std::vector<tuned> objects(100);
+  std::vector<retained<tuned>> refs;
+
+  for (std::size_t n = 0; n < objects.size(); ++n)
+  {
+    objects[n].value = static_cast<int>(n);
+    refs.push_back(make_retained(objects[n]));
+  }
+
+  auto view = gsl::deref(refs);
+
+  CHECK(std::is_same_v<decltype(view), gsl::deref_view<std::vector<retained<tuned>>, 4>>);
+
+  int sum = 0;
+
+  for (auto const& t : view)
+  {
+    sum += t.value;
+  }
+
+  CHECK(sum == 4950);
+}
+
+SCENARIO("`deref` iterators without prefetching are zero-overhead")
+{
+  using view = gsl::deref_view<std::vector<retained<node>>, 0>;
+
+  CHECK(sizeof(view::iterator) == sizeof(std::vector<retained<node>>::iterator));
+}
+
+SCENARIO("`deref` cannot be used with temporary ranges")
+{
+  using range = std::vector<retained<node>>;
+
+  CHECK(can_deref<range&>::value);
+  CHECK(can_deref<range const&>::value);
+  CHECK_FALSE(can_deref<range>::value);
+  CHECK_FALSE(can_deref<range const>::value);
+}
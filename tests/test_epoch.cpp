@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <catch2/catch.hpp>
+
+#include <gsl/epoch.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using gsl::epoch_domain;
+using gsl::guarded_retained;
+using gsl::make_retained;
+using gsl::retained;
+
+namespace
+{
+  struct tracked
+  {
+    explicit tracked(std::atomic<int>& destroyed, int value = 0)
+    : destroyed(destroyed)
+    , value(value)
+    {
+    }
+
+    ~tracked()
+    {
+      ++destroyed;
+    }
+
+    std::atomic<int>& destroyed;
+    int value;
+  };
+
+  struct hooked : epoch_domain::retire_hook, tracked
+  {
+    using tracked::tracked;
+  };
+
+} // namespace
+
+SCENARIO("objects retired to an `epoch_domain` are reclaimed")
+{
+  std::atomic<int> destroyed = {0};
+
+  GIVEN("an object retired with no participants")
+  {
+    epoch_domain domain;
+
+    domain.retire(new tracked(destroyed));
+
+    CHECK(destroyed == 0);
+
+    THEN("it is reclaimed once the epoch advances twice")
+    {
+      domain.collect();
+      domain.collect();
+
+      CHECK(destroyed == 1);
+    }
+  }
+
+  GIVEN("an object retired while a participant is pinned")
+  {
+    epoch_domain domain;
+    epoch_domain::participant participant(domain);
+
+    {
+      auto guard = participant.pin();
+
+      domain.retire(new tracked(destroyed));
+
+      THEN("it is not reclaimed while the participant remains pinned")
+      {
+        domain.collect();
+        domain.collect();
+        domain.collect();
+
+        CHECK(destroyed == 0);
+      }
+    }
+
+    THEN("it is reclaimed after the participant is unpinned")
+    {
+      domain.collect();
+      domain.collect();
+
+      CHECK(destroyed == 1);
+    }
+  }
+
+  GIVEN("an object retired to a domain that is then destroyed")
+  {
+    {
+      epoch_domain domain;
+
+      domain.retire(new tracked(destroyed));
+    }
+
+    CHECK(destroyed == 1);
+  }
+}
+
+SCENARIO("objects can be retired to an `epoch_domain` without locking")
+{
+  std::atomic<int> destroyed = {0};
+
+  GIVEN("objects retired while a participant is pinned")
+  {
+    epoch_domain domain;
+    epoch_domain::participant participant(domain);
+
+    {
+      auto guard = participant.pin();
+
+      domain.retire_lock_free(new hooked(destroyed));
+      domain.retire_lock_free(new hooked(destroyed));
+
+      THEN("they are not reclaimed while the participant remains pinned")
+      {
+        CHECK(domain.collect() == 0);
+        CHECK(destroyed == 0);
+      }
+    }
+
+    THEN("they are reclaimed after the participant is unpinned")
+    {
+      domain.collect();
+
+      CHECK(domain.collect() == 2);
+      CHECK(destroyed == 2);
+    }
+  }
+
+  GIVEN("many objects retired with no participants")
+  {
+    epoch_domain domain;
+
+    for (int i = 0; i < 200; ++i)
+    {
+      domain.retire_lock_free(new hooked(destroyed));
+    }
+
+    THEN("some are reclaimed without an explicit collection")
+    {
+      CHECK(destroyed > 0);
+    }
+  }
+
+  GIVEN("an object retired to a domain that is then destroyed")
+  {
+    {
+      epoch_domain domain;
+
+      domain.retire_lock_free(new hooked(destroyed));
+    }
+
+    CHECK(destroyed == 1);
+  }
+}
+
+SCENARIO("`epoch_guard`s can be nested")
+{
+  epoch_domain domain;
+  epoch_domain::participant participant(domain);
+  std::atomic<int> destroyed = {0};
+
+  {
+    auto outer = participant.pin();
+
+    {
+      auto inner = participant.pin();
+    }
+
+    domain.retire(new tracked(destroyed));
+    domain.collect();
+    domain.collect();
+
+    CHECK(destroyed == 0);
+  }
+
+  domain.collect();
+  domain.collect();
+
+  CHECK(destroyed == 1);
+}
+
+SCENARIO("`guarded_retained` publishes objects to readers")
+{
+  epoch_domain domain;
+  epoch_domain::participant participant(domain);
+  std::atomic<int> destroyed = {0};
+  std::atomic<int> sentinel_destroyed = {0};
+  tracked sentinel(sentinel_destroyed);
+
+  GIVEN("a `guarded_retained` referencing a heap allocated object")
+  {
+    guarded_retained<tracked> current(domain, make_retained(*new tracked(destroyed, 1)));
+
+    {
+      auto guard = participant.pin();
+
+      CHECK(current.load(guard)->value == 1);
+    }
+
+    WHEN("it is replaced while a reader holds a reference")
+    {
+      {
+        auto guard = participant.pin();
+        retained<tracked const> r = std::as_const(current).load(guard);
+
+        current.replace(make_retained(*new tracked(destroyed, 2)));
+        domain.collect();
+        domain.collect();
+
+        THEN("the previous object remains valid")
+        {
+          CHECK(destroyed == 0);
+          CHECK(r->value == 1);
+          CHECK(current.load(guard)->value == 2);
+        }
+      }
+
+      THEN("the previous object is reclaimed once the reader is unpinned")
+      {
+        domain.collect();
+        domain.collect();
+
+        CHECK(destroyed == 1);
+      }
+    }
+
+    current.replace(make_retained(sentinel));
+  }
+}
+
+SCENARIO("`guarded_retained` can be read concurrently with replacement")
+{
+  std::atomic<int> destroyed = {0};
+  std::atomic<bool> done = {false};
+  std::atomic<bool> valid = {true};
+  tracked const sentinel(destroyed, 1);
+
+  {
+    epoch_domain domain;
+    guarded_retained<tracked const> current(
+        domain, make_retained(*new tracked(destroyed, 1)));
+
+    std::vector<std::thread> readers;
+
+    for (int t = 0; t < 2; ++t)
+    {
+      readers.emplace_back([&] {
+        epoch_domain::participant participant(domain);
+
+        while (!done.load(std::memory_order_acquire))
+        {
+          auto guard = participant.pin();
+
+          if (current.load(guard)->value != 1)
+          {
+            valid.store(false);
+          }
+        }
+      });
+    }
+
+    for (int n = 0; n < 1000; ++n)
+    {
+      current.replace(make_retained(*new tracked(destroyed, 1)));
+    }
+
+    done.store(true, std::memory_order_release);
+
+    for (auto& reader : readers)
+    {
+      reader.join();
+    }
+
+    current.replace(make_retained(sentinel));
+  }
+
+  REQUIRE(valid.load());
+  REQUIRE(destroyed == 1001);
+}
@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <catch2/catch.hpp>
+
+#include <gsl/gather.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#if __has_include(<span>)
+#include <span>
+#endif
+
+using gsl::make_optional_ref;
+using gsl::make_retained;
+using gsl::optional_ref;
+using gsl::retained;
+
+namespace
+{
+  struct particle
+  {
+    char tag = {};
+    float mass = {};
+    double energy = {};
+    std::int64_t id = {};
+    std::array<char, 3> name = {};
+  };
+
+  struct identity
+  {
+    int id = {};
+  };
+
+  struct tracked_particle : virtual identity
+  {
+    float mass = {};
+  };
+
+  struct named_particle : std::array<char, 3>, tracked_particle
+  {
+  };
+
+  std::vector<particle> make_particles(std::size_t n)
+  {
+    std::vector<particle> particles(n);
+
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      particles[i].mass = static_cast<float>(i) + 0.5f;
+      particles[i].energy = static_cast<double>(i) * 2.0;
+      particles[i].id = static_cast<std::int64_t>(i) * 1000;
+      particles[i].name = {'p', static_cast<char>('a' + i % 26), '\0'};
+    }
+
+    return particles;
+  }
+} // namespace
+
+SCENARIO("members can be gathered from an array of `retained`")
+{
+  GIVEN("an array of `retained` referencing objects in reverse order")
+  {
+    // Lengths that are not a multiple of the vector width exercise the tail.
+    auto const n = GENERATE(std::size_t(0), 1, 3, 4, 8, 13, 64);
+    auto particles = make_particles(n);
+    std::vector<retained<particle const>> refs;
+
+    for (std::size_t i = n; i != 0; --i)
+    {
+      refs.push_back(make_retained(particles[i - 1]));
+    }
+
+    WHEN("a four-byte member is gathered")
+    {
+      std::vector<float> out(n);
+      gsl::gather(refs.data(), refs.size(), &particle::mass, out.data());
+
+      THEN("each value is copied in order")
+      {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+          CHECK(out[i] == particles[n - i - 1].mass);
+        }
+      }
+    }
+
+    WHEN("eight-byte members are gathered")
+    {
+      std::vector<double> energies(n);
+      std::vector<std::int64_t> ids(n);
+      gsl::gather(refs, &particle::energy, energies);
+      gsl::gather(refs, &particle::id, ids);
+
+      THEN("each value is copied in order")
+      {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+          CHECK(energies[i] == particles[n - i - 1].energy);
+          CHECK(ids[i] == particles[n - i - 1].id);
+        }
+      }
+    }
+
+    WHEN("a member of another size is gathered")
+    {
+      std::vector<std::array<char, 3>> out(n);
+      gsl::gather(refs, &particle::name, out);
+
+      THEN("each value is copied in order")
+      {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+          CHECK(out[i] == particles[n - i - 1].name);
+        }
+      }
+    }
+  }
+
+  GIVEN("objects of a type with a virtual base")
+  {
+    // The type is not standard-layout, so the member is read through each
+    // reference instead of at an offset found from the first object, and the
+    // objects are of different most-derived types.
+    std::vector<tracked_particle> tracked(5);
+    std::vector<named_particle> named(4);
+    std::vector<retained<tracked_particle>> refs;
+
+    for (std::size_t i = 0; i < tracked.size(); ++i)
+    {
+      tracked[i].mass = static_cast<float>(i);
+      refs.push_back(make_retained(tracked[i]));
+
+      if (i < named.size())
+      {
+        named[i].mass = static_cast<float>(i) + 0.5f;
+        refs.push_back(make_retained<tracked_particle>(named[i]));
+      }
+    }
+
+    WHEN("a member is gathered")
+    {
+      std::vector<float> out(refs.size());
+      gsl::gather(refs, &tracked_particle::mass, out);
+
+      THEN("each value is copied in order")
+      {
+        for (std::size_t i = 0; i < refs.size(); ++i)
+        {
+          CHECK(out[i] == refs[i]->mass);
+        }
+      }
+    }
+  }
+}
+
+#if defined(__cpp_lib_span)
+SCENARIO("members can be gathered between `std::span`s")
+{
+  GIVEN("a span of `retained` to const objects")
+  {
+    auto const particles = make_particles(9);
+    std::vector<retained<particle const>> refs;
+
+    for (auto const& p : particles)
+    {
+      refs.emplace_back(p);
+    }
+
+    WHEN("a member is gathered into a temporary span")
+    {
+      std::vector<float> out(particles.size());
+      gsl::gather(
+          std::span<retained<particle const> const>(refs),
+          &particle::mass,
+          std::span<float>(out));
+
+      THEN("each value is copied in order")
+      {
+        for (std::size_t i = 0; i < particles.size(); ++i)
+        {
+          CHECK(out[i] == particles[i].mass);
+        }
+      }
+    }
+  }
+
+  GIVEN("a span of `optional_ref`")
+  {
+    auto particles = make_particles(2);
+    std::array<optional_ref<particle>, 3> refs = {
+        make_optional_ref(particles[0]), std::nullopt, make_optional_ref(particles[1])};
+
+    WHEN("a member is gathered into a temporary span")
+    {
+      std::array<std::int64_t, 3> out = {};
+      gsl::gather(refs, &particle::id, std::span<std::int64_t>(out), std::int64_t(-1));
+
+      THEN("disengaged elements get the default value")
+      {
+        CHECK(out == std::array<std::int64_t, 3>{particles[0].id, -1, particles[1].id});
+      }
+    }
+  }
+}
+#endif
+
+SCENARIO("members can be gathered from an array of `optional_ref`")
+{
+  GIVEN("an array of `optional_ref` with some disengaged elements")
+  {
+    auto const n = GENERATE(std::size_t(1), 4, 8, 13, 64);
+    auto particles = make_particles(n);
+    std::vector<optional_ref<particle>> refs;
+
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      refs.push_back(i % 3 != 1 ? make_optional_ref(particles[i]) : std::nullopt);
+    }
+
+    WHEN("a member is gathered with a default value")
+    {
+      std::vector<float> masses(n);
+      std::vector<std::int64_t> ids(n);
+      gsl::gather(refs.data(), refs.size(), &particle::mass, masses.data(), -1.0f);
+      gsl::gather(refs, &particle::id, ids, std::int64_t(-1));
+
+      THEN("disengaged elements yield the default value")
+      {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+          CHECK(masses[i] == (i % 3 != 1 ? particles[i].mass : -1.0f));
+          CHECK(ids[i] == (i % 3 != 1 ? particles[i].id : -1));
+        }
+      }
+    }
+
+    WHEN("a member is gathered without a default value")
+    {
+      std::vector<double> out(n, 42.0);
+      gsl::gather(refs.data(), refs.size(), &particle::energy, out.data());
+
+      THEN("disengaged elements yield a value-initialized value")
+      {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+          CHECK(out[i] == (i % 3 != 1 ? particles[i].energy : 0.0));
+        }
+      }
+    }
+  }
+
+  GIVEN("an array of disengaged `optional_ref`")
+  {
+    std::array<optional_ref<particle>, 5> refs = {};
+    std::array<float, 5> out = {};
+
+    WHEN("a member is gathered")
+    {
+      gsl::gather(refs, &particle::mass, out, 7.0f);
+
+      THEN("every element yields the default value")
+      {
+        for (auto const value : out)
+        {
+          CHECK(value == 7.0f);
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <catch2/catch.hpp>
+
+#include <gsl/instrument.hpp>
+#include <gsl/optional_ref.hpp>
+#include <gsl/retained.hpp>
+
+#include <string>
+#include <thread>
+
+using gsl::instrument_counter;
+using gsl::make_retained;
+using gsl::optional_ref;
+using gsl::retained;
+
+namespace
+{
+  constexpr int constant = 1;
+  constexpr optional_ref<int const> constant_ref = constant;
+
+  // Counting is skipped during constant evaluation.
+  static_assert(*constant_ref == 1);
+  static_assert(constant_ref.has_value());
+
+} // namespace
+
+SCENARIO("instrumentation does not change the layout of the instrumented types")
+{
+  CHECK(sizeof(retained<int>) == sizeof(int*));
+  CHECK(sizeof(optional_ref<int>) == sizeof(int*));
+}
+
+#if defined(GSL_POINTERS_INSTRUMENT)
+SCENARIO("instrumentation counts the hot paths of `retained` and `optional_ref`")
+{
+  int i = 1;
+  int j = 2;
+
+  retained<int> r = make_retained(i);
+  optional_ref<int> o = i;
+  optional_ref<int> p = j;
+  optional_ref<int> n;
+
+  gsl::drain_instrument_counters();
+
+  GIVEN("dereferences")
+  {
+    *r = 3;
+    *o = 4;
+    static_cast<void>(*p);
+
+    THEN("they are counted")
+    {
+      auto const counts = gsl::drain_instrument_counters();
+
+      CHECK(counts[instrument_counter::dereference] == 3);
+      CHECK(counts[instrument_counter::engagement_check] == 0);
+    }
+  }
+
+  GIVEN("engagement checks")
+  {
+    static_cast<void>(o.has_value());
+    static_cast<void>(bool(n));
+
+    THEN("they are counted")
+    {
+      CHECK(gsl::drain_instrument_counters()[instrument_counter::engagement_check] == 2);
+    }
+  }
+
+  GIVEN("calls to `value` and `value_or`")
+  {
+    static_cast<void>(o.value());
+    CHECK_THROWS(n.value());
+    static_cast<void>(n.value_or(5));
+    static_cast<void>(o.value_or(5));
+    static_cast<void>(n.value_or_ref(j));
+
+    THEN("failures and copies are counted")
+    {
+      auto const counts = gsl::drain_instrument_counters();
+
+      CHECK(counts[instrument_counter::value_failure] == 1);
+      CHECK(counts[instrument_counter::value_or_copy] == 2);
+    }
+  }
+
+  GIVEN("comparisons")
+  {
+    CHECK(o != p);
+    CHECK(o != n);
+    CHECK(n == std::nullopt);
+    CHECK(o == 1);
+    CHECK(r == make_retained(i));
+
+    THEN("only those comparing referenced values are counted as deep")
+    {
+      auto const counts = gsl::drain_instrument_counters();
+
+      CHECK(counts[instrument_counter::deep_comparison] == 2);
+      CHECK(counts[instrument_counter::engagement_check] == 0);
+      CHECK(counts[instrument_counter::dereference] == 0);
+    }
+  }
+
+  GIVEN("counts made by other threads")
+  {
+    std::thread([&] {
+      for (int k = 0; k < 10; ++k)
+      {
+        static_cast<void>(*o);
+      }
+    }).join();
+
+    THEN("they are kept after the thread exits")
+    {
+      CHECK(gsl::drain_instrument_counters()[instrument_counter::dereference] == 10);
+    }
+  }
+
+  THEN("draining resets the counts")
+  {
+    static_cast<void>(*o);
+
+    CHECK(gsl::drain_instrument_counters()[instrument_counter::dereference] == 1);
+    CHECK(gsl::drain_instrument_counters()[instrument_counter::dereference] == 0);
+  }
+}
+#else
+SCENARIO("no counts are reported when instrumentation is disabled")
+{
+  int i = 1;
+  optional_ref<int> o = i;
+
+  static_cast<void>(*o);
+  static_cast<void>(o.has_value());
+
+  auto const counts = gsl::drain_instrument_counters();
+
+  for (auto value : counts.values)
+  {
+    CHECK(value == 0);
+  }
+}
+#endif
+
+SCENARIO("instrument counters have names")
+{
+  CHECK(std::string(gsl::instrument_counter_name(instrument_counter::dereference))
+        == "dereference");
+  CHECK(std::string(gsl::instrument_counter_name(instrument_counter::deep_comparison))
+        == "deep_comparison");
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// These tests are built with exceptions disabled, to check that the headers that
+// report contract violations compile without them.
+
+#include <catch2/catch.hpp>
+
+#include <gsl/gather.hpp>
+#include <gsl/object_pool.hpp>
+#include <gsl/retained_offset.hpp>
+
+#include <array>
+#include <cstdint>
+
+#if defined(GSL_POINTERS_EXCEPTIONS)
+#error "test_no_exceptions.cpp must be built with exceptions disabled"
+#endif
+
+SCENARIO("`retained_offset` can be used without exceptions")
+{
+  int i = {};
+
+  gsl::retained_offset<int> ro(i);
+  gsl::retained_offset<int, std::int16_t> short_ro(i);
+
+  CHECK(&*ro == &i);
+  CHECK(&*short_ro == &i);
+}
+
+SCENARIO("`gather` can be used without exceptions")
+{
+  struct sample
+  {
+    float value;
+  };
+
+  sample samples[2] = {{1.0f}, {2.0f}};
+  std::array<gsl::retained<sample>, 2> refs = {
+      gsl::make_retained(samples[0]), gsl::make_retained(samples[1])};
+  std::array<float, 2> out = {};
+
+  gsl::gather(refs, &sample::value, out);
+
+  CHECK(out[0] == 1.0f);
+  CHECK(out[1] == 2.0f);
+}
+
+SCENARIO("`object_pool` can be used without exceptions")
+{
+  gsl::object_pool<int> pool(1);
+
+  auto const h = pool.emplace(1);
+
+  CHECK(*pool.get(h) == 1);
+  CHECK(!pool.contains(pool.emplace(2)));
+}
@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <catch2/catch.hpp>
+
+#include <gsl/object_pool.hpp>
+
+#include <string>
+#include <type_traits>
+#include <unordered_set>
+
+using gsl::object_pool;
+using gsl::retained_handle;
+
+namespace
+{
+  struct counted
+  {
+    explicit counted(int& live, std::string name)
+    : live(live)
+    , name(std::move(name))
+    {
+      ++live;
+    }
+
+    ~counted()
+    {
+      --live;
+    }
+
+    int& live;
+    std::string name;
+  };
+} // namespace
+
+SCENARIO("`retained_handle` is a small value type")
+{
+  CHECK(sizeof(retained_handle<int>) == 8);
+  CHECK(std::is_trivially_copyable_v<retained_handle<int>>);
+  CHECK(std::is_convertible_v<retained_handle<int>, retained_handle<int const>>);
+  CHECK(!std::is_convertible_v<retained_handle<int const>, retained_handle<int>>);
+  CHECK(!std::is_constructible_v<retained_handle<int>, retained_handle<int const>>);
+  CHECK(!std::is_assignable_v<retained_handle<int>&, retained_handle<int const>>);
+  CHECK(retained_handle<int>() == retained_handle<int const>());
+}
+
+SCENARIO("objects can be created in and erased from an `object_pool`")
+{
+  GIVEN("an empty pool")
+  {
+    int live = 0;
+    object_pool<counted> pool(2);
+
+    CHECK(pool.empty());
+    CHECK(pool.capacity() == 2);
+
+    THEN("a default-constructed handle refers to no object")
+    {
+      CHECK(!pool.contains({}));
+      CHECK(!pool.get({}));
+      CHECK(!pool.erase({}));
+    }
+
+    WHEN("objects are created")
+    {
+      auto a = pool.emplace(live, "a");
+      auto b = pool.emplace(live, "b");
+
+      THEN("they can be accessed through their handles")
+      {
+        CHECK(live == 2);
+        CHECK(pool.size() == 2);
+        CHECK(a != b);
+        CHECK(pool.contains(a));
+        CHECK(pool.get(a)->name == "a");
+        CHECK(pool.retain(b)->name == "b");
+
+        auto const& cpool = pool;
+        gsl::optional_ref<counted const> cb = cpool.get(b);
+        CHECK(&*cb == &*pool.get(b));
+      }
+
+      THEN("the pool is full")
+      {
+        auto const c = pool.emplace(live, "c");
+
+        CHECK(c == retained_handle<counted>());
+        CHECK(!pool.contains(c));
+        CHECK(live == 2);
+        CHECK(pool.size() == 2);
+      }
+
+      AND_WHEN("an object is erased")
+      {
+        CHECK(pool.erase(a));
+
+        THEN("its handle no longer refers to an object")
+        {
+          CHECK(live == 1);
+          CHECK(!pool.contains(a));
+          CHECK(!pool.get(a));
+          CHECK(!pool.retain(a));
+          CHECK(!pool.erase(a));
+          CHECK(pool.contains(b));
+        }
+
+        AND_WHEN("its slot is reused")
+        {
+          auto c = pool.emplace(live, "c");
+
+          THEN("the old handle does not refer to the new object")
+          {
+            CHECK(c.index() == a.index());
+            CHECK(c.generation() != a.generation());
+            CHECK(!pool.get(a));
+            CHECK(pool.get(c)->name == "c");
+          }
+        }
+      }
+
+      AND_WHEN("the pool is cleared")
+      {
+        pool.clear();
+
+        THEN("every object is destroyed")
+        {
+          CHECK(live == 0);
+          CHECK(pool.empty());
+          CHECK(!pool.contains(a));
+          CHECK(!pool.contains(b));
+        }
+      }
+    }
+  }
+
+  GIVEN("a pool that is destroyed while holding objects")
+  {
+    int live = 0;
+
+    {
+      object_pool<counted> pool(4);
+      pool.emplace(live, "a");
+      pool.emplace(live, "b");
+      pool.erase(pool.emplace(live, "c"));
+    }
+
+    THEN("every object is destroyed")
+    {
+      CHECK(live == 0);
+    }
+  }
+}
+
+SCENARIO("`retained_handle`s can be used as keys")
+{
+  GIVEN("handles to several objects")
+  {
+    object_pool<int> pool(3);
+    std::unordered_set<retained_handle<int>> handles;
+
+    handles.insert(pool.emplace(1));
+    handles.insert(pool.emplace(2));
+    handles.insert(pool.emplace(3));
+
+    THEN("they are distinct")
+    {
+      CHECK(handles.size() == 3);
+    }
+  }
+}
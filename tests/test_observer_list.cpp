@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <catch2/catch.hpp>
+
+#include <gsl/observer_list.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using gsl::epoch_domain;
+using gsl::make_retained;
+using gsl::observer_list;
+
+namespace
+{
+  struct counter
+  {
+    std::atomic<int> count = {0};
+
+    void operator()() noexcept
+    {
+      count.fetch_add(1, std::memory_order_relaxed);
+    }
+  };
+
+  void notify_all(observer_list<counter>& list, epoch_domain::participant& participant)
+  {
+    auto guard = participant.pin();
+    list.notify(guard, [](counter& c) { c(); });
+  }
+
+} // namespace
+
+SCENARIO("`observer_list` notifies its subscribers")
+{
+  epoch_domain domain;
+  epoch_domain::participant participant(domain);
+  observer_list<counter> list(domain);
+
+  counter a;
+  counter b;
+
+  GIVEN("an empty list")
+  {
+    THEN("it has no subscribers")
+    {
+      auto guard = participant.pin();
+      CHECK(list.size(guard) == 0);
+    }
+
+    THEN("unsubscribing fails")
+    {
+      auto guard = participant.pin();
+      CHECK(!list.unsubscribe(guard, a));
+    }
+  }
+
+  GIVEN("a list with two subscribers")
+  {
+    {
+      auto guard = participant.pin();
+      list.subscribe(guard, make_retained(a));
+      list.subscribe(guard, make_retained(b));
+    }
+
+    THEN("notification calls both")
+    {
+      notify_all(list, participant);
+
+      CHECK(a.count == 1);
+      CHECK(b.count == 1);
+    }
+
+    WHEN("one is unsubscribed")
+    {
+      {
+        auto guard = participant.pin();
+        CHECK(list.unsubscribe(guard, a));
+        CHECK(list.size(guard) == 1);
+      }
+
+      notify_all(list, participant);
+
+      THEN("only the other is notified")
+      {
+        CHECK(a.count == 0);
+        CHECK(b.count == 1);
+      }
+
+      THEN("it cannot be unsubscribed again")
+      {
+        auto guard = participant.pin();
+        CHECK(!list.unsubscribe(guard, a));
+      }
+    }
+
+    WHEN("one is subscribed again")
+    {
+      {
+        auto guard = participant.pin();
+        list.subscribe(guard, make_retained(a));
+      }
+
+      notify_all(list, participant);
+
+      THEN("it is notified once per subscription")
+      {
+        CHECK(a.count == 2);
+        CHECK(b.count == 1);
+      }
+
+      THEN("each subscription is removed separately")
+      {
+        auto guard = participant.pin();
+        CHECK(list.unsubscribe(guard, a));
+        CHECK(list.size(guard) == 2);
+        CHECK(list.unsubscribe(guard, a));
+        CHECK(list.size(guard) == 1);
+        CHECK(!list.unsubscribe(guard, a));
+      }
+    }
+  }
+
+  GIVEN("a list with many unsubscribed observers")
+  {
+    std::vector<counter> observers(200);
+
+    {
+      auto guard = participant.pin();
+
+      for (auto& o : observers)
+      {
+        list.subscribe(guard, make_retained(o));
+      }
+
+      for (std::size_t i = 0; i < observers.size(); i += 2)
+      {
+        list.unsubscribe(guard, observers[i]);
+      }
+    }
+
+    THEN("the remaining observers are still notified")
+    {
+      notify_all(list, participant);
+
+      for (std::size_t i = 0; i < observers.size(); ++i)
+      {
+        CHECK(observers[i].count == static_cast<int>(i % 2));
+      }
+    }
+
+    THEN("removed entries and replaced snapshots are reclaimed")
+    {
+      domain.collect();
+      domain.collect();
+
+      CHECK(domain.collect() == 0);
+    }
+  }
+}
+
+SCENARIO("`observer_list` can be notified concurrently with subscription")
+{
+  epoch_domain domain;
+  observer_list<counter> list(domain);
+
+  counter permanent;
+  std::vector<counter> transient(64);
+  std::atomic<bool> done = {false};
+  std::atomic<bool> valid = {true};
+
+  {
+    epoch_domain::participant participant(domain);
+    auto guard = participant.pin();
+    list.subscribe(guard, make_retained(permanent));
+  }
+
+  std::vector<std::thread> threads;
+  std::atomic<int> notifications = {0};
+
+  for (int t = 0; t < 2; ++t)
+  {
+    threads.emplace_back([&] {
+      epoch_domain::participant participant(domain);
+
+      while (!done.load(std::memory_order_acquire))
+      {
+        notify_all(list, participant);
+        notifications.fetch_add(1, std::memory_order_relaxed);
+      }
+    });
+  }
+
+  for (int t = 0; t < 2; ++t)
+  {
+    threads.emplace_back([&, t] {
+      epoch_domain::participant participant(domain);
+
+      for (int n = 0; n < 200; ++n)
+      {
+        for (std::size_t i = t; i < transient.size(); i += 2)
+        {
+          auto guard = participant.pin();
+          list.subscribe(guard, make_retained(transient[i]));
+        }
+
+        for (std::size_t i = t; i < transient.size(); i += 2)
+        {
+          auto guard = participant.pin();
+          if (!list.unsubscribe(guard, transient[i]))
+          {
+            valid.store(false);
+          }
+        }
+
+        domain.collect();
+      }
+    });
+  }
+
+  threads[2].join();
+  threads[3].join();
+  done.store(true, std::memory_order_release);
+  threads[0].join();
+  threads[1].join();
+
+  epoch_domain::participant participant(domain);
+  auto guard = participant.pin();
+
+  REQUIRE(valid.load());
+  CHECK(list.size(guard) == 1);
+  CHECK(permanent.count == notifications);
+}
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <catch2/catch.hpp>
+
+#include <gsl/optional_in.hpp>
+
+#include <string>
+#include <type_traits>
+
+using gsl::optional_in;
+using gsl::optional_ref;
+
+namespace
+{
+  struct point
+  {
+    int x;
+    int y;
+  };
+
+  int get_or(optional_in<int> o, int fallback)
+  {
+    return o.value_or(fallback);
+  }
+
+  std::size_t length(optional_in<std::string> o)
+  {
+    return o ? o->size() : 0;
+  }
+
+  template <typename O, typename F, typename = void>
+  struct can_value_or_ref : std::false_type
+  {
+  };
+
+  template <typename O, typename F>
+  struct can_value_or_ref<
+      O,
+      F,
+      std::void_t<decltype(std::declval<O const&>().value_or_ref(std::declval<F>()))>>
+  : std::true_type
+  {
+  };
+} // namespace
+
+SCENARIO("`optional_in` holds small trivially copyable types by value")
+{
+  CHECK(std::is_same_v<optional_in<int>, gsl::detail::optional_in_value<int>>);
+  CHECK(std::is_same_v<
+        optional_in<double const>,
+        gsl::detail::optional_in_value<double>>);
+  CHECK(std::is_same_v<optional_in<point>, gsl::detail::optional_in_value<point>>);
+  CHECK(std::is_trivially_copyable_v<optional_in<point>>);
+
+  CHECK(std::is_same_v<optional_in<std::string>, optional_ref<std::string const>>);
+  CHECK(std::is_same_v<optional_in<char[64]>, optional_ref<char const[64]>>);
+}
+
+SCENARIO("`optional_in` does not accept temporary fallbacks")
+{
+  // Both representations must reject them, or the same call would compile
+  // depending on the size of the type.
+  CHECK(can_value_or_ref<optional_in<int>, int const&>::value);
+  CHECK(!can_value_or_ref<optional_in<int>, int>::value);
+  CHECK(!can_value_or_ref<optional_in<int>, int const>::value);
+
+  CHECK(can_value_or_ref<optional_in<std::string>, std::string const&>::value);
+  CHECK(!can_value_or_ref<optional_in<std::string>, std::string>::value);
+}
+
+SCENARIO("`optional_in` can be passed like `optional_ref`")
+{
+  GIVEN("a function taking a by-value `optional_in`")
+  {
+    int i = 1;
+    optional_ref<int> r = i;
+
+    THEN("it can be passed lvalues, temporaries, `optional_ref`s and `nullopt`")
+    {
+      CHECK(get_or(i, 0) == 1);
+      CHECK(get_or(2, 0) == 2);
+      CHECK(get_or(r, 0) == 1);
+      CHECK(get_or(optional_ref<int>(), 0) == 0);
+      CHECK(get_or(std::nullopt, 3) == 3);
+      CHECK(get_or({}, 4) == 4);
+    }
+  }
+
+  GIVEN("a function taking a by-reference `optional_in`")
+  {
+    std::string s = "abc";
+
+    THEN("it can be passed lvalues, temporaries and `nullopt`")
+    {
+      CHECK(length(s) == 3);
+      CHECK(length(std::string("abcd")) == 4);
+      CHECK(length(std::nullopt) == 0);
+    }
+  }
+}
+
+SCENARIO("by-value `optional_in` can be accessed and compared")
+{
+  GIVEN("an engaged and a disengaged `optional_in`")
+  {
+    point p = {1, 2};
+    optional_in<point> x = p;
+    optional_in<point> o;
+
+    THEN("the engaged one holds a copy of the value")
+    {
+      CHECK(x.has_value());
+      CHECK(x->y == 2);
+      CHECK((*x).x == 1);
+      CHECK(x.value().x == 1);
+      CHECK(&*x != &p);
+    }
+
+    THEN("the disengaged one throws on access")
+    {
+      CHECK(!o);
+      CHECK_THROWS_AS(o.value(), std::bad_optional_access);
+      CHECK(&o.value_or_ref(p) == &p);
+    }
+  }
+
+  GIVEN("`optional_in`s of a comparable type")
+  {
+    optional_in<int> x = 1;
+    optional_in<int> o = std::nullopt;
+
+    THEN("they can be compared with values and `nullopt`")
+    {
+      CHECK((x == 1));
+      CHECK((1 == x));
+      CHECK((x != 2));
+      CHECK((o != 1));
+      CHECK((o == std::nullopt));
+      CHECK((std::nullopt != x));
+    }
+  }
+
+  GIVEN("a constant expression")
+  {
+    constexpr optional_in<int> x = 5;
+
+    THEN("it can be used in constant expressions")
+    {
+      static_assert(*x == 5);
+      static_assert(x.value_or(0) == 5);
+      static_assert(!optional_in<int>());
+    }
+  }
+}
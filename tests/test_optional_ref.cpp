@@ -26,7 +26,9 @@
 
 #include <array>
 #include <map>
+#include <memory>
 #include <set>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -356,6 +358,240 @@ SCENARIO("`optional_ref` can be arithmetically compared")
   }
 }
 
+#if defined(GSL_POINTERS_THREE_WAY_COMPARISON)
+SCENARIO("`optional_ref` is three-way comparable")
+{
+  GIVEN("`optional_ref`s to a type that counts its three-way comparisons")
+  {
+    struct key
+    {
+      int value;
+      int* count;
+
+      std::strong_ordering operator<=>(key const& other) const
+      {
+        ++*count;
+        return value <=> other.value;
+      }
+
+      bool operator==(key const& other) const
+      {
+        return value == other.value;
+      }
+    };
+
+    int count = 0;
+    key a = {0, &count};
+    key b = {1, &count};
+
+    optional_ref<key> x = a;
+    optional_ref<key> y = b;
+    optional_ref<key> o;
+
+    THEN("each relational comparison compares the values once")
+    {
+      CHECK((x <=> y) == std::strong_ordering::less);
+      CHECK((x < y));
+      CHECK(!(x >= y));
+      CHECK((y > a));
+      CHECK((a <= y));
+      CHECK(count == 5);
+    }
+
+    THEN("disengaged `optional_ref`s are ordered first without comparing values")
+    {
+      CHECK((o <=> x) == std::strong_ordering::less);
+      CHECK((o <=> std::nullopt) == std::strong_ordering::equal);
+      CHECK((std::nullopt < x));
+      CHECK((o < a));
+      CHECK(count == 0);
+    }
+  }
+
+  GIVEN("`optional_ref`s to a type that is only `<` comparable")
+  {
+    struct key
+    {
+      int value;
+
+      bool operator<(key const& other) const
+      {
+        return value < other.value;
+      }
+    };
+
+    key a = {0};
+    key b = {1};
+
+    optional_ref<key> x = a;
+    optional_ref<key> y = b;
+
+    THEN("a weak ordering is synthesized")
+    {
+      CHECK((x <=> y) == std::weak_ordering::less);
+      CHECK((y <=> x) == std::weak_ordering::greater);
+      CHECK((x <=> x) == std::weak_ordering::equivalent);
+      CHECK((x <=> optional_ref<key>()) == std::weak_ordering::greater);
+    }
+  }
+}
+#endif
+
+SCENARIO("`optional_ref` can fall back to another reference")
+{
+  GIVEN("an engaged and a disengaged `optional_ref` to a non-copyable type")
+  {
+    std::unique_ptr<int> i;
+    std::unique_ptr<int> fallback;
+
+    optional_ref<std::unique_ptr<int>> x = i;
+    optional_ref<std::unique_ptr<int>> o;
+
+    THEN("`value_or_ref` returns the referenced object or the fallback")
+    {
+      CHECK(&x.value_or_ref(fallback) == &i);
+      CHECK(&o.value_or_ref(fallback) == &fallback);
+    }
+  }
+}
+
+SCENARIO("`optional_ref` supports monadic operations")
+{
+  struct config
+  {
+    std::string name;
+    optional_ref<config const> parent;
+  };
+
+  config root = {"root", {}};
+  config child = {"child", root};
+
+  optional_ref<config const> x = child;
+  optional_ref<config const> o;
+
+  GIVEN("a function returning an optional")
+  {
+    auto parent = [](config const& c) { return c.parent; };
+
+    THEN("`and_then` chains lookups")
+    {
+      CHECK(&*x.and_then(parent) == &root);
+      CHECK(!x.and_then(parent).and_then(parent));
+      CHECK(!o.and_then(parent));
+    }
+  }
+
+  GIVEN("a member projection")
+  {
+    THEN("`transform` returns a reference to the member")
+    {
+      optional_ref<std::string const> name = x.transform(&config::name);
+
+      CHECK(&*name == &child.name);
+      CHECK(!o.transform(&config::name));
+    }
+  }
+
+  GIVEN("a function returning a value")
+  {
+    auto size = [](config const& c) { return c.name.size(); };
+
+    THEN("`transform` returns an `std::optional`")
+    {
+      std::optional<std::size_t> s = x.transform(size);
+
+      CHECK(s == 5u);
+      CHECK(!o.transform(size));
+    }
+  }
+
+  GIVEN("a function returning a fallback")
+  {
+    int calls = 0;
+    auto fallback = [&] {
+      ++calls;
+      return optional_ref<config const>(root);
+    };
+
+    THEN("`or_else` only invokes it if disengaged")
+    {
+      CHECK(&*x.or_else(fallback) == &child);
+      CHECK(calls == 0);
+      CHECK(&*o.or_else(fallback) == &root);
+      CHECK(calls == 1);
+    }
+  }
+}
+
+namespace
+{
+  struct constant_base
+  {
+    int value;
+  };
+
+  struct constant_derived : constant_base
+  {
+  };
+
+  constexpr constant_derived constant_object = {{1}};
+  constexpr int constant_other = 2;
+
+  constexpr gsl::optional_ref<constant_derived const> constant_ref = constant_object;
+  constexpr gsl::optional_ref<constant_base const> constant_converted = constant_ref;
+  constexpr gsl::optional_ref<int const> constant_none = std::nullopt;
+
+} // namespace
+
+SCENARIO("`optional_ref`s can be used in constant expressions")
+{
+  static_assert(&*constant_converted == &constant_object);
+  static_assert(constant_converted->value == 1);
+  static_assert(constant_none == std::nullopt);
+  static_assert(constant_none == constant_none);
+  static_assert(constant_none.value_or(3) == 3);
+  static_assert(&constant_none.value_or_ref(constant_other) == &constant_other);
+  static_assert(gsl::make_optional_ref(constant_other) != constant_none);
+  static_assert(constant_none < gsl::make_optional_ref(constant_other));
+}
+
+SCENARIO("arrays of `optional_ref`s can be viewed as arrays of pointers")
+{
+  GIVEN("an array of `optional_ref`s")
+  {
+    int i[] = {1, 2};
+    std::array<optional_ref<int>, 3> refs = {i[0], {}, i[1]};
+
+    THEN("they can be viewed as an array of pointers")
+    {
+      int* const* ptrs = gsl::as_pointers(refs.data());
+
+      REQUIRE(ptrs[0] == &i[0]);
+      REQUIRE(ptrs[1] == nullptr);
+      REQUIRE(ptrs[2] == &i[1]);
+    }
+
+    THEN("the pointers can be viewed as an array of `optional_ref`s")
+    {
+      int* ptrs[] = {nullptr, &i[1]};
+      optional_ref<int> const* back = gsl::as_optional_refs(ptrs);
+
+      REQUIRE(!back[0]);
+      REQUIRE(&*back[1] == &i[1]);
+    }
+
+#if defined(__cpp_lib_span)
+    THEN("they can be viewed as a span of pointers")
+    {
+      std::span<int* const, 3> ptrs = gsl::as_pointers(std::span(refs));
+
+      REQUIRE(ptrs[1] == nullptr);
+      REQUIRE(gsl::as_optional_refs(ptrs).data() == refs.data());
+    }
+#endif
+  }
+}
+
 SCENARIO("`optional_ref`s can be used with STL containers")
 {
   std::array<int, 3> i = {0, 1, 2};
@@ -425,3 +661,85 @@ SCENARIO("`optional_ref`s can be used with STL containers")
     REQUIRE(set.find(make_optional_ref(i[2])) != set.end());
   }
 }
+
+SCENARIO("`optional_ref`s can be compared and hashed by identity")
+{
+  // Neither comparable nor hashable.
+  struct blob
+  {
+    char data[64];
+  };
+
+  std::array<blob, 3> blobs = {};
+  std::array<int, 2> equal = {7, 7};
+
+  GIVEN("two references to equal but distinct objects")
+  {
+    optional_ref<int> a = equal[0];
+    optional_ref<int> b = equal[1];
+
+    THEN("they are equal by value but not by identity")
+    {
+      CHECK(a == b);
+      CHECK_FALSE(gsl::identity_equal_to()(a, b));
+      CHECK(gsl::identity_equal_to()(a, make_optional_ref(equal[0])));
+      CHECK(gsl::identity_less()(a, b) != gsl::identity_less()(b, a));
+    }
+  }
+
+  GIVEN("disengaged references")
+  {
+    optional_ref<blob> n;
+
+    THEN("they are all identical")
+    {
+      CHECK(gsl::identity_equal_to()(n, optional_ref<blob>()));
+      CHECK(gsl::identity_equal_to()(n, std::nullopt));
+      CHECK(gsl::identity_hash()(n) == gsl::identity_hash()(std::nullopt));
+      CHECK(gsl::identity_less()(n, make_optional_ref(blobs[0])));
+    }
+  }
+
+  GIVEN("an `unordered_map` keyed by identity")
+  {
+    using hash = gsl::identity_hash;
+    using equal_to = gsl::identity_equal_to;
+    std::unordered_map<optional_ref<blob>, int, hash, equal_to> map;
+
+    map.emplace(blobs[0], 0);
+    map.emplace(blobs[1], 1);
+    map.emplace(std::nullopt, -1);
+
+    THEN("it can be searched using references and `std::nullopt`")
+    {
+      CHECK(map.at(blobs[1]) == 1);
+      CHECK(map.find(make_optional_ref(blobs[2])) == map.end());
+      CHECK(map.find(std::nullopt)->second == -1);
+    }
+
+#if defined(__cpp_lib_generic_unordered_lookup)
+    THEN("it can be searched using pointers")
+    {
+      CHECK(map.find(&blobs[0])->second == 0);
+      CHECK(map.find(&blobs[2]) == map.end());
+    }
+#endif
+  }
+
+  GIVEN("a `set` ordered by identity")
+  {
+    std::set<optional_ref<blob const>, gsl::identity_less> set;
+
+    set.emplace(blobs[2]);
+    set.emplace(blobs[0]);
+    set.emplace(std::nullopt);
+
+    THEN("it can be searched using pointers")
+    {
+      CHECK(set.size() == 3);
+      CHECK(set.find(&blobs[0]) != set.end());
+      CHECK(set.find(&blobs[1]) == set.end());
+      CHECK(!*set.begin());
+    }
+  }
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// The core header is included first to check that it is self-contained.
+#include <gsl/optional_ref_core.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <optional>
+
+using gsl::optional_ref;
+
+namespace
+{
+  struct node
+  {
+    int value;
+    optional_ref<node const> parent;
+
+    optional_ref<node const> get_parent() const noexcept
+    {
+      return parent;
+    }
+
+    int get_value() const noexcept
+    {
+      return value;
+    }
+  };
+
+} // namespace
+
+SCENARIO("`optional_ref_core.hpp` provides `optional_ref` without its hashing support")
+{
+  node root = {1, {}};
+  node child = {2, root};
+
+  optional_ref<node const> x = child;
+  optional_ref<node const> o;
+
+  GIVEN("a pointer to a member function")
+  {
+    THEN("`and_then` and `transform` call it on the referenced object")
+    {
+      CHECK(&*x.and_then(&node::get_parent) == &root);
+      CHECK(!o.and_then(&node::get_parent));
+      CHECK(x.transform(&node::get_value) == std::optional<int>(2));
+      CHECK(o.transform(&node::get_value) == std::nullopt);
+    }
+  }
+
+  GIVEN("a pointer to a data member")
+  {
+    THEN("`transform` yields a reference to the member")
+    {
+      auto value = x.transform(&node::value);
+
+      CHECK(std::is_same_v<decltype(value), optional_ref<int const>>);
+      CHECK(&*value == &child.value);
+      CHECK(!o.transform(&node::value));
+    }
+  }
+
+  GIVEN("a fallback function")
+  {
+    THEN("`or_else` calls it only when disengaged")
+    {
+      auto fallback = [&] { return optional_ref<node const>(root); };
+
+      CHECK(&*x.or_else(fallback) == &child);
+      CHECK(&*o.or_else(fallback) == &root);
+    }
+  }
+}
@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <catch2/catch.hpp>
+
+#include <gsl/optional_retained.hpp>
+
+#include <array>
+#include <map>
+#include <optional>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace
+{
+  struct base
+  {
+    virtual ~base()
+    {
+    }
+  };
+
+  struct derived : base
+  {
+  };
+
+} // namespace
+
+using gsl::make_retained;
+using gsl::optional_retained;
+using gsl::retained;
+
+SCENARIO("`optional_retained` is the same size as a pointer")
+{
+  CHECK(sizeof(optional_retained<int>) == sizeof(int*));
+  CHECK(alignof(optional_retained<int>) == alignof(int*));
+  CHECK(sizeof(optional_retained<base>) == sizeof(base*));
+}
+
+SCENARIO("`optional_retained` is trivially movable and destructible")
+{
+  CHECK(std::is_trivially_move_constructible_v<optional_retained<int>>);
+  CHECK(std::is_trivially_move_assignable_v<optional_retained<int>>);
+  CHECK(std::is_trivially_destructible_v<optional_retained<int>>);
+}
+
+SCENARIO("`optional_retained`s cannot be copied")
+{
+  CHECK_FALSE(std::is_copy_constructible_v<optional_retained<int>>);
+  CHECK_FALSE(std::is_copy_assignable_v<optional_retained<int>>);
+}
+
+SCENARIO("`optional_retained` can be disengaged")
+{
+  GIVEN("a default constructed `optional_retained`")
+  {
+    optional_retained<int> o;
+
+    CHECK(!o);
+    CHECK(!o.has_value());
+    CHECK(o == std::nullopt);
+  }
+
+  GIVEN("an `optional_retained` constructed from `std::nullopt`")
+  {
+    optional_retained<int> o = std::nullopt;
+
+    CHECK(!o);
+    CHECK(!o.has_value());
+  }
+
+  GIVEN("an engaged `optional_retained`")
+  {
+    int i = {};
+
+    optional_retained<int> o = make_retained(i);
+
+    WHEN("it is reset")
+    {
+      o.reset();
+
+      CHECK(!o);
+    }
+
+    WHEN("it is assigned `std::nullopt`")
+    {
+      o = std::nullopt;
+
+      CHECK(!o);
+    }
+  }
+}
+
+SCENARIO("`optional_retained` can be constructed from `retained`")
+{
+  GIVEN("an `optional_retained` constructed from a `retained<int>`")
+  {
+    int i = {};
+
+    optional_retained<int> o = make_retained(i);
+
+    CHECK(o);
+    CHECK(o.has_value());
+    CHECK(&*o == &i);
+    CHECK(o == make_retained(i));
+    CHECK(o != std::nullopt);
+
+    THEN("an `optional_retained<int const>` move constructed from it")
+    {
+      optional_retained<int const> p = std::move(o);
+
+      CHECK(&*p == &i);
+    }
+  }
+
+  GIVEN("an `optional_retained<base>` constructed from a `retained<derived>`")
+  {
+    derived d;
+
+    optional_retained<base> o = make_retained(d);
+
+    CHECK(&*o == &d);
+  }
+
+  GIVEN("a disengaged `optional_retained` assigned a `retained`")
+  {
+    int i = {};
+
+    optional_retained<int> o;
+    o = make_retained(i);
+
+    CHECK(&*o == &i);
+  }
+}
+
+SCENARIO("`optional_retained` can be accessed via the throwing `value` function")
+{
+  GIVEN("an engaged `optional_retained`")
+  {
+    int i = {};
+
+    optional_retained<int> o = make_retained(i);
+
+    CHECK(&o.value() == &i);
+
+    THEN("the value can be bound to a `value_type`")
+    {
+      optional_retained<int>::value_type v = o.value();
+
+      CHECK(&v == &i);
+      CHECK(std::is_same_v<optional_retained<int>::value_type, decltype(o.value())>);
+      CHECK(std::is_same_v<optional_retained<int>::value_type, decltype(*o)>);
+    }
+  }
+
+  GIVEN("a disengaged `optional_retained`")
+  {
+    optional_retained<int> const o;
+
+    CHECK_THROWS_AS(o.value(), std::bad_optional_access);
+  }
+}
+
+SCENARIO("`optional_retained` maintains const-correctness")
+{
+  int i = {};
+
+  optional_retained<int> o = make_retained(i);
+  optional_retained<int> const& c = o;
+
+  CHECK(std::is_same_v<decltype(*o), int&>);
+  CHECK(std::is_same_v<decltype(*c), int const&>);
+  CHECK(std::is_same_v<decltype(o.operator->()), int*>);
+  CHECK(std::is_same_v<decltype(c.operator->()), int const*>);
+  CHECK(std::is_same_v<decltype(c.value()), int const&>);
+}
+
+SCENARIO("`optional_retained`s can be swapped")
+{
+  int i = {};
+
+  optional_retained<int> v = make_retained(i);
+  optional_retained<int> w;
+
+  swap(v, w);
+
+  CHECK(!v);
+  CHECK(w == make_retained(i));
+}
+
+SCENARIO("`optional_retained`s support equality comparison")
+{
+  std::array<int, 2> is = {1, 2};
+
+  optional_retained<int> x = make_retained(is[0]);
+  optional_retained<int> y = make_retained(is[1]);
+  optional_retained<int> z = make_retained(is[0]);
+  optional_retained<int> o;
+
+  CHECK(x == z);
+  CHECK(x != y);
+  CHECK(x != o);
+  CHECK(o == optional_retained<int>());
+  CHECK(make_retained(is[0]) == x);
+  CHECK(make_retained(is[1]) != x);
+  CHECK(std::nullopt == o);
+  CHECK(std::nullopt != x);
+}
+
+SCENARIO("`optional_retained`s can be used with STL containers")
+{
+  std::array<int, 3> i = {0, 1, 2};
+
+  GIVEN("a `vector` of `optional_retained`s")
+  {
+    std::vector<optional_retained<int>> vector;
+
+    vector.emplace_back(make_retained(i[2]));
+    vector.emplace_back();
+    vector.emplace_back(make_retained(i[0]));
+
+    REQUIRE(vector[0] == make_retained(i[2]));
+    REQUIRE(vector[1] == std::nullopt);
+    REQUIRE(vector[2] == make_retained(i[0]));
+  }
+
+  GIVEN("a `set` of `optional_retained`s")
+  {
+    std::set<optional_retained<int>> set;
+
+    set.emplace(make_retained(i[0]));
+    set.emplace(make_retained(i[1]));
+    set.emplace();
+
+    REQUIRE(set.size() == 3);
+    REQUIRE(set.find(optional_retained<int>(make_retained(i[1]))) != set.end());
+    REQUIRE(set.find(std::nullopt) != set.end());
+  }
+
+  GIVEN("an `unordered_set` of `optional_retained`s")
+  {
+    std::unordered_set<optional_retained<int>> set;
+
+    set.emplace(make_retained(i[0]));
+    set.emplace(make_retained(i[1]));
+    set.emplace();
+
+    REQUIRE(set.size() == 3);
+    REQUIRE(set.find(optional_retained<int>(make_retained(i[1]))) != set.end());
+    REQUIRE(set.find(std::nullopt) != set.end());
+  }
+}
@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <catch2/catch.hpp>
+
+#include <gsl/reference_view.hpp>
+
+#include <array>
+#include <iterator>
+#include <list>
+#include <vector>
+
+#if __has_include(<span>)
+#include <span>
+#endif
+
+using gsl::optional_ref;
+using gsl::retained;
+
+namespace
+{
+  struct widget
+  {
+    int value = {};
+  };
+
+  int total(retained<widget const> w)
+  {
+    return w->value;
+  }
+
+  template <typename Range, typename = void>
+  struct can_view_retained : std::false_type
+  {
+  };
+
+  template <typename Range>
+  struct can_view_retained<
+      Range,
+      std::void_t<decltype(gsl::views::retained(std::declval<Range>()))>>
+  : std::true_type
+  {
+  };
+
+  template <typename Range, typename = void>
+  struct can_pipe_optional_ref : std::false_type
+  {
+  };
+
+  template <typename Range>
+  struct can_pipe_optional_ref<
+      Range,
+      std::void_t<decltype(std::declval<Range>() | gsl::views::optional_ref)>>
+  : std::true_type
+  {
+  };
+
+} // namespace
+
+SCENARIO("`views::retained` yields a `retained` to each element")
+{
+  std::vector<widget> widgets = {widget{1}, widget{2}, widget{3}};
+
+  GIVEN("a view of a mutable range")
+  {
+    auto view = gsl::views::retained(widgets);
+
+    CHECK(std::is_same_v<decltype(*view.begin()), retained<widget>>);
+
+    THEN("each element is referenced in order")
+    {
+      std::size_t n = 0;
+
+      for (retained<widget> w : view)
+      {
+        CHECK(&*w == &widgets[n++]);
+        w->value *= 10;
+      }
+
+      CHECK(n == widgets.size());
+      CHECK(widgets[2].value == 30);
+    }
+
+    THEN("its iterators support random access")
+    {
+      auto it = view.begin();
+
+      CHECK(view.end() - it == 3);
+      CHECK(&*it[2] == &widgets[2]);
+      CHECK(&**(it + 1) == &widgets[1]);
+      CHECK(it < view.end());
+    }
+  }
+
+  GIVEN("a view of a read-only range")
+  {
+    auto view = std::as_const(widgets) | gsl::views::retained;
+
+    CHECK(std::is_same_v<decltype(*view.begin()), retained<widget const>>);
+
+    int sum = 0;
+
+    for (auto w : view)
+    {
+      sum += total(std::move(w));
+    }
+
+    CHECK(sum == 6);
+  }
+
+  GIVEN("a view of a range that is not random access")
+  {
+    std::list<widget> list(2);
+
+    auto view = gsl::views::retained(list);
+
+    auto last = view.end();
+    --last;
+
+    CHECK(&**last == &list.back());
+    CHECK(std::distance(view.begin(), view.end()) == 2);
+  }
+
+  GIVEN("a view of an array")
+  {
+    widget array[2] = {widget{4}, widget{5}};
+
+    auto view = array | gsl::views::retained;
+
+    CHECK((*view.begin())->value == 4);
+  }
+}
+
+SCENARIO("`views::optional_ref` yields an `optional_ref` to each element")
+{
+  std::array<int, 3> i = {1, 2, 3};
+
+  GIVEN("a range of objects")
+  {
+    auto view = gsl::views::optional_ref(i);
+
+    CHECK(std::is_same_v<decltype(*view.begin()), optional_ref<int>>);
+
+    THEN("every reference is engaged")
+    {
+      for (auto o : view)
+      {
+        CHECK(o);
+      }
+
+      CHECK(&*view.begin()[1] == &i[1]);
+    }
+  }
+
+  GIVEN("a range of pointers")
+  {
+    std::vector<int const*> ptrs = {&i[2], nullptr, &i[0]};
+
+    auto view = ptrs | gsl::views::optional_ref;
+
+    CHECK(std::is_same_v<decltype(*view.begin()), optional_ref<int const>>);
+
+    THEN("null pointers yield disengaged references")
+    {
+      auto it = view.begin();
+
+      CHECK(&**it++ == &i[2]);
+      CHECK(!*it++);
+      CHECK(&**it++ == &i[0]);
+      CHECK(it == view.end());
+    }
+  }
+}
+
+SCENARIO("reference views cannot be used with temporary ranges")
+{
+  using range = std::vector<widget>;
+
+  CHECK(can_view_retained<range&>::value);
+  CHECK(can_view_retained<range const&>::value);
+  CHECK_FALSE(can_view_retained<range>::value);
+  CHECK_FALSE(can_view_retained<range const>::value);
+
+  CHECK(can_pipe_optional_ref<range&>::value);
+  CHECK_FALSE(can_pipe_optional_ref<range>::value);
+
+#if defined(GSL_POINTERS_RANGES)
+  // Views are stored by value, so temporary views can be viewed.
+  CHECK(can_view_retained<std::span<widget>>::value);
+  CHECK(can_pipe_optional_ref<std::ranges::ref_view<range>>::value);
+  CHECK(can_pipe_optional_ref<std::ranges::owning_view<range>>::value);
+#endif
+}
+
+#if defined(GSL_POINTERS_RANGES)
+SCENARIO("reference views are C++20 views")
+{
+  using view_type = gsl::retained_view<std::vector<widget>>;
+
+  CHECK(std::ranges::view<view_type>);
+  CHECK(std::ranges::random_access_range<view_type>);
+  CHECK(std::ranges::borrowed_range<view_type>);
+  CHECK(std::ranges::bidirectional_range<gsl::optional_ref_view<std::list<int*>>>);
+
+  std::vector<widget> widgets = {widget{1}, widget{2}, widget{3}};
+  auto view = widgets | gsl::views::retained;
+
+  CHECK(view.size() == 3);
+  CHECK(&*view.back() == &widgets[2]);
+
+  auto tail = view | std::views::drop(1);
+
+  CHECK(&**std::ranges::begin(tail) == &widgets[1]);
+
+  WHEN("a view is on the left of the pipeline")
+  {
+    auto head = widgets | std::views::take(2) | gsl::views::retained;
+
+    CHECK(std::ranges::random_access_range<decltype(head)>);
+    CHECK(std::ranges::borrowed_range<decltype(head)>);
+    CHECK(std::ranges::distance(head) == 2);
+    CHECK(&*head[1] == &widgets[1]);
+  }
+
+  WHEN("the view on the left has a sentinel")
+  {
+    auto small = widgets
+        | std::views::take_while([](widget const& w) { return w.value < 3; })
+        | gsl::views::retained;
+
+    CHECK(!std::ranges::common_range<decltype(small)>);
+    CHECK(std::ranges::distance(small) == 2);
+  }
+
+  WHEN("a temporary `std::span` is viewed")
+  {
+    auto spanned = gsl::views::optional_ref(std::span<widget>(widgets));
+
+    CHECK(std::ranges::borrowed_range<decltype(spanned)>);
+    CHECK(&*spanned.back() == &widgets[2]);
+  }
+}
+#endif
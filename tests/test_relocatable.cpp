@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <catch2/catch.hpp>
+
+#include <gsl/optional_ref.hpp>
+#include <gsl/optional_retained.hpp>
+#include <gsl/relocatable.hpp>
+#include <gsl/retained.hpp>
+#include <gsl/retained_offset.hpp>
+
+#include <memory>
+#include <string>
+
+using gsl::make_retained;
+using gsl::retained;
+
+namespace
+{
+  template <typename T, std::size_t N>
+  struct storage
+  {
+    alignas(T) unsigned char bytes[N * sizeof(T)];
+
+    T* data() noexcept
+    {
+      return reinterpret_cast<T*>(bytes);
+    }
+  };
+} // namespace
+
+SCENARIO("reference types are trivially relocatable")
+{
+  CHECK(gsl::is_trivially_relocatable_v<retained<int>>);
+  CHECK(gsl::is_trivially_relocatable_v<gsl::optional_ref<int>>);
+  CHECK(gsl::is_trivially_relocatable_v<gsl::optional_retained<int>>);
+  CHECK(gsl::is_trivially_relocatable_v<int>);
+  CHECK(gsl::is_trivially_relocatable_v<std::unique_ptr<int>> == false);
+
+  // A self-relative offset is only valid at the address it was computed at.
+  CHECK(gsl::is_trivially_relocatable_v<gsl::retained_offset<int>> == false);
+}
+
+SCENARIO("objects can be relocated")
+{
+  GIVEN("a trivially relocatable object")
+  {
+    int i = {};
+    storage<retained<int>, 2> s;
+    auto* source = ::new (s.data()) retained<int>(i);
+
+    WHEN("it is relocated")
+    {
+      auto* dest = gsl::relocate_at(source, s.data() + 1);
+
+      THEN("the destination references the same object")
+      {
+        CHECK(&**dest == &i);
+      }
+    }
+  }
+
+  GIVEN("an object that is not trivially relocatable")
+  {
+    storage<std::string, 2> s;
+    auto* source = ::new (s.data()) std::string(100, 'x');
+
+    WHEN("it is relocated")
+    {
+      auto* dest = gsl::relocate_at(source, s.data() + 1);
+
+      THEN("the destination holds the value")
+      {
+        CHECK(*dest == std::string(100, 'x'));
+      }
+
+      std::destroy_at(dest);
+    }
+  }
+}
+
+SCENARIO("ranges of objects can be relocated")
+{
+  GIVEN("a buffer of `retained`s")
+  {
+    int i[] = {0, 1, 2, 3};
+    storage<retained<int>, 5> s;
+    auto* const p = s.data();
+
+    for (int n = 0; n < 4; ++n)
+    {
+      ::new (p + n) retained<int>(i[n]);
+    }
+
+    WHEN("the tail is relocated down over an erased element")
+    {
+      std::destroy_at(p + 1);
+      auto* end = gsl::uninitialized_relocate(p + 2, p + 4, p + 1);
+
+      THEN("the remaining elements are contiguous")
+      {
+        CHECK(end == p + 3);
+        CHECK(&*p[0] == &i[0]);
+        CHECK(&*p[1] == &i[2]);
+        CHECK(&*p[2] == &i[3]);
+      }
+    }
+
+    WHEN("the tail is relocated up to make room for an inserted element")
+    {
+      auto* begin = gsl::uninitialized_relocate_backward(p + 1, p + 4, p + 5);
+      ::new (p + 1) retained<int>(i[3]);
+
+      THEN("the elements are shifted by one")
+      {
+        CHECK(begin == p + 2);
+        CHECK(&*p[0] == &i[0]);
+        CHECK(&*p[1] == &i[3]);
+        CHECK(&*p[2] == &i[1]);
+        CHECK(&*p[4] == &i[3]);
+      }
+    }
+  }
+
+  GIVEN("a buffer of objects that are not trivially relocatable")
+  {
+    storage<std::string, 4> s;
+    auto* const p = s.data();
+
+    for (int n = 0; n < 3; ++n)
+    {
+      ::new (p + n) std::string(50, char('a' + n));
+    }
+
+    WHEN("the elements are relocated down and back up")
+    {
+      std::destroy_at(p);
+      gsl::uninitialized_relocate(p + 1, p + 3, p);
+      gsl::uninitialized_relocate_backward(p, p + 2, p + 4);
+
+      THEN("the values are preserved")
+      {
+        CHECK(p[2] == std::string(50, 'b'));
+        CHECK(p[3] == std::string(50, 'c'));
+      }
+
+      std::destroy(p + 2, p + 4);
+    }
+  }
+}
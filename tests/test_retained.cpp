@@ -28,8 +28,11 @@
 #include <array>
 #include <map>
 #include <set>
+#include <string>
+#include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 using gsl::make_retained;
@@ -204,6 +207,51 @@ SCENARIO("`retained`s support equality and `less` comparison")
   }
 }
 
+SCENARIO("`retained`s can be hashed with `retained_hash`")
+{
+  struct alignas(64) block
+  {
+    char bytes[64];
+  };
+
+  std::array<block, 16> blocks = {};
+
+  GIVEN("`retained`s constructed from entries in an array of over-aligned objects")
+  {
+    THEN("equal `retained`s have equal hashes")
+    {
+      REQUIRE(
+          gsl::retained_hash<block>()(make_retained(blocks[3]))
+          == gsl::retained_hash<block>()(make_retained(blocks[3])));
+    }
+
+    THEN("the low bits of the hashes are well distributed")
+    {
+      std::set<std::size_t> buckets;
+
+      for (auto& b : blocks)
+      {
+        buckets.insert(gsl::retained_hash<block>()(make_retained(b)) % blocks.size());
+      }
+
+      REQUIRE(buckets.size() > 1);
+    }
+  }
+
+  GIVEN("an `unordered_set` using `retained_hash`")
+  {
+    std::unordered_set<retained<block>, gsl::retained_hash<block>> set;
+
+    for (auto& b : blocks)
+    {
+      set.emplace(b);
+    }
+
+    REQUIRE(set.size() == blocks.size());
+    REQUIRE(set.find(make_retained(blocks[5])) != set.end());
+  }
+}
+
 SCENARIO("`retained`s can be created using `make_retained`")
 {
   int i = {};
@@ -216,12 +264,255 @@ SCENARIO("`retained`s can be created using `make_retained`")
   }
 }
 
-SCENARIO("`retained`s can be used in certain constant expressions")
+namespace
+{
+  constexpr int constant_i = 1;
+  constexpr int constant_j = 2;
+  int mutable_i = {};
+
+  constexpr retained<int const> constant_r = make_retained(constant_i);
+
+  constexpr bool swap_in_constant_expression()
+  {
+    retained<int const> r1 = make_retained(constant_i);
+    retained<int const> r2 = make_retained(constant_j);
+
+    r1.swap(r2);
+    bool const member = &*r1 == &constant_j && &*r2 == &constant_i;
+
+    swap(r1, r2);
+    bool const free = &*r1 == &constant_i && &*r2 == &constant_j;
+
+    return member && free;
+  }
+
+  constexpr bool assign_in_constant_expression()
+  {
+    retained<int const> r = make_retained(constant_i);
+    r = make_retained(mutable_i);
+
+    return r == make_retained(mutable_i) && r != constant_r;
+  }
+
+  // A state machine whose states refer to each other, which must be
+  // initialized at compile time despite the cycle.
+  struct state
+  {
+    char const* name;
+    retained<state const> next;
+  };
+
+  extern state const stopped;
+  extern state const running;
+
+  constexpr state stopped = {"stopped", make_retained(running)};
+  constexpr state running = {"running", make_retained(stopped)};
+
+#if defined(__cpp_constinit)
+  constinit state paused = {"paused", make_retained(running)};
+#endif
+
+} // namespace
+
+SCENARIO("`retained`s can be used in constant expressions")
+{
+  static_assert(*constant_r == 1);
+  static_assert(constant_r == make_retained(constant_i));
+  static_assert(swap_in_constant_expression());
+  static_assert(assign_in_constant_expression());
+
+  GIVEN("a graph of objects that refer to each other with `retained`s")
+  {
+    static_assert(&*stopped.next == &running);
+    static_assert(&*(*running.next).next == &running);
+    static_assert((*(*running.next).next).name[0] == 'r');
+
+    THEN("it is traversable at run time")
+    {
+      CHECK(std::string((*stopped.next).name) == "running");
+      CHECK(std::string((*(*(*running.next).next).next).name) == "stopped");
+    }
+
+#if defined(__cpp_constinit)
+    THEN("it can be referenced by objects with constant initialization")
+    {
+      CHECK(&*paused.next == &running);
+
+      paused.next = make_retained(stopped);
+
+      CHECK(&*paused.next == &stopped);
+    }
+#endif
+  }
+}
+
+SCENARIO("`retained`s support heterogeneous lookup")
+{
+  std::array<int, 3> i = {0, 1, 2};
+  int j = {};
+
+  GIVEN("a `set` of `retained`s")
+  {
+    std::set<retained<int>> set;
+
+    set.emplace(i[0]);
+    set.emplace(i[1]);
+
+    std::array<int, 3> const& c = i;
+
+    THEN("it can be searched using references, pointers and `retained`s")
+    {
+      REQUIRE(set.find(i[0]) != set.end());
+      REQUIRE(set.find(c[1]) != set.end());
+      REQUIRE(set.find(&c[0]) != set.end());
+      REQUIRE(set.find(&i[1]) != set.end());
+      REQUIRE(set.find(make_retained(c[1])) != set.end());
+      REQUIRE(set.find(i[2]) == set.end());
+      REQUIRE(set.find(&j) == set.end());
+      REQUIRE(set.count(make_retained(c[2])) == 0);
+    }
+  }
+
+  GIVEN("a `set` of `retained<int const>`s")
+  {
+    std::set<retained<int const>> set;
+
+    set.emplace(i[0]);
+
+    REQUIRE(set.find(make_retained(i[0])) != set.end());
+    REQUIRE(set.find(i[0]) != set.end());
+    REQUIRE(set.find(&i[1]) == set.end());
+  }
+
+  GIVEN("the transparent `std` function objects")
+  {
+    std::less<retained<int>> less;
+    std::equal_to<retained<int>> equal_to;
+    std::hash<retained<int>> hash;
+    gsl::retained_hash<int> retained_hash;
+
+    REQUIRE(less(i[0], &i[1]));
+    REQUIRE(!less(make_retained(i[1]), i[0]));
+    REQUIRE(equal_to(make_retained(i[0]), &i[0]));
+    REQUIRE(!equal_to(i[0], make_retained(i[1])));
+    REQUIRE(hash(i[0]) == hash(make_retained(i[0])));
+    REQUIRE(hash(&i[1]) == hash(make_retained(i[1])));
+    REQUIRE(retained_hash(i[2]) == retained_hash(make_retained(i[2])));
+  }
+
+  GIVEN("keys that only convert to the referenced type")
+  {
+    using less = std::less<retained<int>>;
+    using equal_to = std::equal_to<retained<int>>;
+    using hash = std::hash<retained<int>>;
+
+    THEN("they are rejected instead of binding to temporaries")
+    {
+      CHECK(std::is_invocable_v<less, int const&, int const&>);
+      CHECK(!std::is_invocable_v<less, int const&, long const&>);
+      CHECK(!std::is_invocable_v<equal_to, retained<int> const&, short const&>);
+      CHECK(!std::is_invocable_v<hash, long const&>);
+      CHECK(!std::is_invocable_v<gsl::retained_hash<int>, double const&>);
+      CHECK(!std::is_invocable_v<hash, long const*>);
+    }
+  }
+
+  GIVEN("temporaries of the referenced type")
+  {
+    using less = std::less<retained<int>>;
+    using equal_to = std::equal_to<retained<int>>;
+    using hash = std::hash<retained<int>>;
+
+    THEN("they are rejected")
+    {
+      CHECK(!std::is_invocable_v<less, int, int const&>);
+      CHECK(!std::is_invocable_v<less, int const&, int&&>);
+      CHECK(!std::is_invocable_v<equal_to, int const&&, retained<int> const&>);
+      CHECK(!std::is_invocable_v<equal_to, retained<int>, int>);
+      CHECK(!std::is_invocable_v<hash, int>);
+      CHECK(!std::is_invocable_v<gsl::retained_hash<int>, int&&>);
+    }
+
+    THEN("temporary `retained`s and pointers are accepted")
+    {
+      CHECK(std::is_invocable_v<less, retained<int>, int*>);
+      CHECK(std::is_invocable_v<equal_to, int const*, retained<int const>>);
+      CHECK(std::is_invocable_v<hash, retained<int>>);
+      CHECK(std::is_invocable_v<gsl::retained_hash<int>, int*>);
+    }
+  }
+
+#if defined(__cpp_lib_generic_unordered_lookup)
+  GIVEN("an `unordered_set` of `retained`s")
+  {
+    std::unordered_set<retained<int>> set;
+
+    set.emplace(i[0]);
+    set.emplace(i[1]);
+
+    REQUIRE(set.find(i[0]) != set.end());
+    REQUIRE(set.find(&i[1]) != set.end());
+    REQUIRE(set.find(i[2]) == set.end());
+  }
+#endif
+}
+
+SCENARIO("arrays of `retained`s can be viewed as arrays of pointers")
 {
-  // !!! Not working on MSVC
-  // constexpr static int const i = {};
-  // constexpr retained<int const> const o = make_retained(i);
-  // constexpr int j = *o;
+  GIVEN("an array of `retained`s")
+  {
+    int i[] = {1, 2, 3};
+    std::vector<retained<int>> refs;
+
+    for (auto& e : i)
+    {
+      refs.push_back(make_retained(e));
+    }
+
+    THEN("they can be viewed as an array of pointers")
+    {
+      int* const* ptrs = gsl::as_pointers(refs.data());
+      int const* const* cptrs = gsl::as_pointers(std::as_const(refs).data());
+
+      REQUIRE(static_cast<void const*>(ptrs) == refs.data());
+      REQUIRE(ptrs[0] == &i[0]);
+      REQUIRE(ptrs[2] == &i[2]);
+      REQUIRE(cptrs[1] == &i[1]);
+
+      *ptrs[0] = 4;
+      REQUIRE(i[0] == 4);
+    }
+
+    THEN("the pointers can be viewed as an array of `retained`s")
+    {
+      retained<int> const* back = gsl::as_retained(gsl::as_pointers(refs.data()), 3);
+      retained<int> const* unchecked =
+          gsl::as_retained_unchecked(gsl::as_pointers(refs.data()));
+
+      REQUIRE(back == refs.data());
+      REQUIRE(&*back[1] == &i[1]);
+      REQUIRE(unchecked == refs.data());
+    }
+
+#if defined(__cpp_lib_span)
+    THEN("they can be viewed as a span of pointers")
+    {
+      std::span<int* const> ptrs = gsl::as_pointers(std::span(refs));
+      std::span<int const* const> cptrs =
+          gsl::as_pointers(std::span(std::as_const(refs)));
+
+      REQUIRE(ptrs.size() == 3);
+      REQUIRE(cptrs.size() == 3);
+      REQUIRE(ptrs[2] == &i[2]);
+      REQUIRE(cptrs[2] == &i[2]);
+
+      std::span<retained<int> const> back = gsl::as_retained(ptrs);
+
+      REQUIRE(back.data() == refs.data());
+      REQUIRE(back.size() == 3);
+    }
+#endif
+  }
 }
 
 SCENARIO("`retained`s can be used with STL containers")
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// The core header is included first to check that it is self-contained.
+#include <gsl/retained_core.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <type_traits>
+
+using gsl::make_retained;
+using gsl::retained;
+
+SCENARIO("`retained_core.hpp` provides `retained` without its hashing support")
+{
+  int i = 1;
+  int j = 2;
+
+  retained<int> r1 = make_retained(i);
+  retained<int> r2 = make_retained(j);
+
+  THEN("`retained`s can be compared and swapped")
+  {
+    CHECK(r1 != r2);
+
+    swap(r1, r2);
+
+    CHECK(&*r1 == &j);
+    CHECK(&*r2 == &i);
+  }
+
+  THEN("`retained` is trivially relocatable")
+  {
+    CHECK(gsl::is_trivially_relocatable_v<retained<int>>);
+  }
+
+  THEN("arrays of `retained`s can be viewed as arrays of pointers")
+  {
+    retained<int> refs[] = {make_retained(i), make_retained(j)};
+
+    CHECK(gsl::as_pointers(refs)[1] == &j);
+  }
+}
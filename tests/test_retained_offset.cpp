@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <catch2/catch.hpp>
+
+#include <gsl/retained_offset.hpp>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+using gsl::make_retained;
+using gsl::make_retained_offset;
+using gsl::optional_retained_offset;
+using gsl::retained_offset;
+
+namespace
+{
+  struct node
+  {
+    explicit node(int value)
+    : value(value)
+    {
+    }
+
+    int value;
+    optional_retained_offset<node> next;
+  };
+
+} // namespace
+
+SCENARIO("`retained_offset` is the same size as its offset type")
+{
+  CHECK(sizeof(retained_offset<int>) == sizeof(std::int32_t));
+  CHECK(sizeof(retained_offset<int, std::int16_t>) == sizeof(std::int16_t));
+  CHECK(sizeof(retained_offset<int, std::int64_t>) == sizeof(std::int64_t));
+  CHECK(sizeof(optional_retained_offset<int>) == sizeof(std::int32_t));
+}
+
+SCENARIO("`retained_offset`s cannot be copied or constructed from temporaries")
+{
+  CHECK_FALSE(std::is_copy_constructible_v<retained_offset<int>>);
+  CHECK_FALSE(std::is_copy_assignable_v<retained_offset<int>>);
+  CHECK_FALSE(std::is_constructible_v<retained_offset<int const>, int&&>);
+  CHECK(std::is_constructible_v<retained_offset<int const>, int const&>);
+  CHECK_FALSE(std::is_convertible_v<int&, retained_offset<int>>);
+}
+
+SCENARIO("`retained_offset`s can be used to access the objects they reference")
+{
+  int i = 1;
+  int j = 2;
+
+  GIVEN("a `retained_offset` constructed from a reference")
+  {
+    retained_offset<int> r = make_retained_offset(i);
+
+    REQUIRE(&*r == &i);
+    REQUIRE(*r == 1);
+    REQUIRE(r == make_retained_offset(i));
+    REQUIRE(r != make_retained_offset(j));
+    REQUIRE(r.get() == make_retained(i));
+
+    WHEN("it is moved")
+    {
+      retained_offset<int> s = std::move(r);
+
+      THEN("the offset is recomputed")
+      {
+        REQUIRE(&*s == &i);
+        REQUIRE(&*r == &i);
+        REQUIRE(s.offset() != r.offset());
+      }
+    }
+
+    WHEN("it is assigned")
+    {
+      r = make_retained_offset(j);
+
+      REQUIRE(&*r == &j);
+    }
+
+    WHEN("it is swapped")
+    {
+      retained_offset<int> s(j);
+
+      swap(r, s);
+
+      REQUIRE(&*r == &j);
+      REQUIRE(&*s == &i);
+    }
+  }
+
+  GIVEN("a `retained_offset` constructed from a `retained`")
+  {
+    retained_offset<int const> r(make_retained(i));
+
+    REQUIRE(&*r == &i);
+  }
+}
+
+SCENARIO("`retained_offset` maintains const-correctness")
+{
+  int i = {};
+
+  retained_offset<int> r(i);
+  retained_offset<int> const& c = r;
+
+  CHECK(std::is_same_v<decltype(*r), int&>);
+  CHECK(std::is_same_v<decltype(*c), int const&>);
+  CHECK(std::is_same_v<decltype(r.get()), gsl::retained<int>>);
+  CHECK(std::is_same_v<decltype(c.get()), gsl::retained<int const>>);
+}
+
+SCENARIO("`retained_offset` can reference objects within range of its offset type")
+{
+  using short_offset = retained_offset<char, std::int16_t>;
+
+  std::vector<char> buffer(1 << 20);
+
+  void* holder = &buffer[buffer.size() - 64];
+  auto const ro = new (holder) short_offset(buffer[buffer.size() - 128]);
+
+  CHECK(&**ro == &buffer[buffer.size() - 128]);
+  CHECK(ro->offset() == -64);
+}
+
+SCENARIO("`retained_offset` can be moved without throwing")
+{
+  CHECK(std::is_nothrow_move_constructible_v<retained_offset<int>>);
+  CHECK(std::is_nothrow_move_assignable_v<retained_offset<int>>);
+  CHECK(std::is_nothrow_swappable_v<retained_offset<int>>);
+  CHECK(std::is_nothrow_move_constructible_v<optional_retained_offset<int>>);
+  CHECK(std::is_nothrow_move_assignable_v<optional_retained_offset<int>>);
+}
+
+SCENARIO("`optional_retained_offset` can be disengaged")
+{
+  int i = {};
+
+  optional_retained_offset<int> o;
+
+  CHECK(!o);
+  CHECK(o == std::nullopt);
+  CHECK_THROWS_AS(o.value(), std::bad_optional_access);
+
+  WHEN("it is assigned a `retained`")
+  {
+    o = make_retained(i);
+
+    CHECK(o);
+    CHECK(&o.value() == &i);
+
+    WHEN("it is reset")
+    {
+      o.reset();
+
+      CHECK(!o);
+    }
+  }
+
+  WHEN("it is assigned a `retained_offset`")
+  {
+    o = make_retained_offset(i);
+
+    CHECK(&*o == &i);
+  }
+}
+
+SCENARIO("structures wired with `retained_offset` are position-independent")
+{
+  GIVEN("a linked list constructed in a buffer")
+  {
+    alignas(node) unsigned char buffer[3 * sizeof(node)];
+    auto nodes = reinterpret_cast<node*>(buffer);
+
+    for (int n = 0; n < 3; ++n)
+    {
+      new (&nodes[n]) node(n);
+    }
+
+    nodes[0].next = make_retained(nodes[1]);
+    nodes[1].next = make_retained(nodes[2]);
+
+    WHEN("the buffer is copied byte-for-byte")
+    {
+      alignas(node) unsigned char copy[sizeof(buffer)];
+      std::memcpy(copy, buffer, sizeof(buffer));
+
+      auto copied = reinterpret_cast<node*>(copy);
+
+      THEN("the copied list references the copied nodes")
+      {
+        REQUIRE(&*copied[0].next == &copied[1]);
+        REQUIRE(&*copied[1].next == &copied[2]);
+        REQUIRE(!copied[2].next);
+        REQUIRE(copied[0].next->next->value == 2);
+      }
+    }
+  }
+}
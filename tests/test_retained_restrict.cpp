@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <catch2/catch.hpp>
+
+#include <gsl/retained_restrict.hpp>
+
+#include <array>
+#include <type_traits>
+
+using gsl::make_retained_restrict;
+using gsl::retained_restrict;
+
+namespace
+{
+  void add(
+      retained_restrict<float>::pointer out,
+      retained_restrict<float const>::const_pointer in,
+      std::size_t n)
+  {
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      out[i] += in[i];
+    }
+  }
+} // namespace
+
+SCENARIO("`retained_restrict` is a move-only reference")
+{
+  CHECK(std::is_trivially_move_constructible_v<retained_restrict<int>>);
+  CHECK(!std::is_copy_constructible_v<retained_restrict<int>>);
+  CHECK(!std::is_constructible_v<retained_restrict<int>, int&&>);
+  CHECK(std::is_constructible_v<retained_restrict<int const>, gsl::retained<int>&&>);
+  CHECK(gsl::is_trivially_relocatable_v<retained_restrict<int>>);
+  CHECK(sizeof(retained_restrict<int>) == sizeof(int*));
+}
+
+SCENARIO("`retained_restrict` can be used to access the objects it references")
+{
+  GIVEN("a `retained_restrict` to an object")
+  {
+    std::array<int, 2> a = {1, 2};
+    auto r = make_retained_restrict(a);
+    auto const& cr = r;
+
+    THEN("the object can be accessed")
+    {
+      CHECK(r.get() == &a);
+      CHECK(std::is_same_v<decltype(cr.get()), std::array<int, 2> const*>);
+      CHECK((*r)[1] == 2);
+      CHECK(r->size() == 2);
+    }
+
+    WHEN("it is moved and swapped")
+    {
+      std::array<int, 2> b = {};
+      auto s = make_retained_restrict(b);
+      auto m = std::move(r);
+      swap(m, s);
+
+      THEN("the references are exchanged")
+      {
+        CHECK(m.get() == &b);
+        CHECK(s.get() == &a);
+      }
+    }
+  }
+}
+
+SCENARIO("`retained_restrict` can be used in place of `retained`")
+{
+  GIVEN("`retained_restrict`s to two objects")
+  {
+    int i = {};
+    int j = {};
+    retained_restrict<int> r(i);
+    retained_restrict<int const> c(gsl::make_retained(i));
+    retained_restrict<int> s(j);
+
+    THEN("they convert to pointers to const")
+    {
+      int const* p = r;
+
+      CHECK(p == &i);
+      CHECK(!std::is_convertible_v<retained_restrict<int> const&, int*>);
+    }
+
+    THEN("they compare by address")
+    {
+      CHECK(r == c);
+      CHECK(!(r != c));
+      CHECK(r != s);
+      CHECK(!(c == s));
+    }
+  }
+}
+
+SCENARIO("`retained_restrict`s can be passed to `restrict` kernels")
+{
+  GIVEN("two disjoint buffers")
+  {
+    std::array<float, 8> x = {1, 2, 3, 4, 5, 6, 7, 8};
+    std::array<float, 8> const y = {8, 7, 6, 5, 4, 3, 2, 1};
+
+    retained_restrict<float> out(x[0]);
+    retained_restrict<float const> in(y[0]);
+
+    WHEN("they are registered in a `restrict_scope`")
+    {
+      gsl::restrict_scope scope;
+      scope.add(out, x.size()).add(in, y.size());
+
+      THEN("they can be passed to a kernel")
+      {
+        add(out.get(), in.get(), x.size());
+
+        for (auto const v : x)
+        {
+          CHECK(v == 9.0f);
+        }
+      }
+    }
+
+    WHEN("read-only references to the same buffer are registered")
+    {
+      retained_restrict<float const> again(y[4]);
+
+      THEN("no violation is reported")
+      {
+        gsl::restrict_scope scope(in, again);
+        scope.add(in, y.size());
+        CHECK(true);
+      }
+    }
+  }
+}
@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <catch2/catch.hpp>
+
+#include <gsl/retained_span.hpp>
+
+#include <array>
+#include <numeric>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using gsl::make_retained_span;
+using gsl::retained_span;
+
+namespace
+{
+  struct parser
+  {
+    explicit parser(std::vector<char>& buffer)
+    : header(retained_span<char>(buffer).first(2))
+    , body(retained_span<char>(buffer).subspan(2))
+    {
+    }
+
+    retained_span<char> header;
+    retained_span<char> body;
+  };
+
+  int sum(retained_span<int const> const& s)
+  {
+    return std::accumulate(s.begin(), s.end(), 0);
+  }
+} // namespace
+
+SCENARIO("`retained_span` is a move-only view")
+{
+  using span = retained_span<int>;
+  using const_span = retained_span<int const>;
+
+  CHECK(std::is_trivially_move_constructible_v<span>);
+  CHECK(!std::is_copy_constructible_v<span>);
+  CHECK(!std::is_copy_assignable_v<span>);
+  CHECK(gsl::is_trivially_relocatable_v<span>);
+  CHECK(sizeof(span) == 2 * sizeof(int*));
+
+  CHECK(std::is_constructible_v<span, std::vector<int>&>);
+  CHECK(std::is_constructible_v<span, int (&)[4]>);
+  CHECK(std::is_constructible_v<span, std::array<int, 4>&>);
+  CHECK(!std::is_convertible_v<std::vector<int>&, span>);
+  CHECK(!std::is_constructible_v<span, std::vector<int>&&>);
+  CHECK(!std::is_constructible_v<const_span, std::vector<int> const&&>);
+  CHECK(!std::is_constructible_v<span, std::vector<int> const&>);
+  CHECK(std::is_constructible_v<const_span, std::vector<int> const&>);
+  CHECK(!std::is_constructible_v<span, std::vector<long>&>);
+  CHECK(!std::is_constructible_v<span, span&>);
+  CHECK(!std::is_constructible_v<const_span, span&>);
+
+  CHECK(std::is_convertible_v<span&&, const_span>);
+  CHECK(!std::is_convertible_v<const_span&&, span>);
+}
+
+SCENARIO("`retained_span` can be used to access the elements it references")
+{
+  GIVEN("a `retained_span` to a vector")
+  {
+    std::vector<int> v = {1, 2, 3, 4, 5};
+    auto s = make_retained_span(v);
+    auto const& cs = s;
+
+    THEN("the elements can be accessed")
+    {
+      CHECK(s.data() == v.data());
+      CHECK(s.size() == 5);
+      CHECK(s.size_bytes() == 5 * sizeof(int));
+      CHECK(!s.empty());
+      CHECK(s[2] == 3);
+      CHECK(s.front() == 1);
+      CHECK(s.back() == 5);
+      CHECK(std::distance(s.begin(), s.end()) == 5);
+    }
+
+    THEN("they can be modified through a non-const `retained_span`")
+    {
+      for (auto& i : s)
+      {
+        i *= 2;
+      }
+
+      CHECK(v == std::vector<int>{2, 4, 6, 8, 10});
+    }
+
+    THEN("they are const through a const `retained_span`")
+    {
+      CHECK(std::is_same_v<decltype(cs[0]), int const&>);
+      CHECK(std::is_same_v<decltype(cs.data()), int const*>);
+      CHECK(std::is_same_v<decltype(cs.begin()), int const*>);
+      CHECK(std::is_same_v<decltype(cs.first(1)), retained_span<int const>>);
+      CHECK(std::is_same_v<decltype(s.first(1)), retained_span<int>>);
+    }
+
+    THEN("subranges can be taken")
+    {
+      CHECK(sum(s.first(2)) == 3);
+      CHECK(sum(s.last(2)) == 9);
+      CHECK(sum(s.subspan(1, 3)) == 9);
+      CHECK(sum(s.subspan(3)) == 9);
+      CHECK(s.subspan(5).empty());
+      CHECK(cs.subspan(1).data() == v.data() + 1);
+    }
+
+    WHEN("it is moved and swapped")
+    {
+      std::vector<int> w = {6};
+      auto t = make_retained_span(w);
+      auto m = std::move(s);
+      swap(m, t);
+
+      THEN("the views are exchanged")
+      {
+        CHECK(m.data() == w.data());
+        CHECK(m.size() == 1);
+        CHECK(t.data() == v.data());
+        CHECK(t.size() == 5);
+      }
+    }
+  }
+
+  GIVEN("a `retained_span` to a pointer and size")
+  {
+    char buffer[] = "GET /";
+    auto s = make_retained_span(buffer + 0, 3);
+
+    THEN("it views that range")
+    {
+      CHECK(std::string(s.begin(), s.end()) == "GET");
+    }
+  }
+
+  GIVEN("a class that keeps views into a buffer")
+  {
+    std::vector<char> buffer = {'h', 'd', 'b', 'o', 'd', 'y'};
+    parser p(buffer);
+
+    THEN("the views reference the buffer")
+    {
+      CHECK(std::string(p.header.begin(), p.header.end()) == "hd");
+      CHECK(std::string(p.body.begin(), p.body.end()) == "body");
+      CHECK(p.body.data() == buffer.data() + 2);
+    }
+  }
+}
+
+SCENARIO("`retained_span`s can be used in constant expressions")
+{
+  static constexpr int values[] = {1, 2, 3};
+  constexpr auto s = retained_span<int const>(values);
+
+  STATIC_REQUIRE(s.size() == 3);
+  STATIC_REQUIRE(s[1] == 2);
+  STATIC_REQUIRE(s.last(1).front() == 3);
+}
+
+#if defined(__cpp_lib_span)
+SCENARIO("`retained_span` can be viewed as a `std::span`")
+{
+  std::array<int, 3> a = {1, 2, 3};
+  auto s = make_retained_span(a);
+  auto const& cs = s;
+
+  CHECK(std::is_same_v<decltype(gsl::as_span(s)), std::span<int>>);
+  CHECK(std::is_same_v<decltype(gsl::as_span(cs)), std::span<int const>>);
+  CHECK(gsl::as_span(s).data() == a.data());
+  CHECK(gsl::as_span(cs).size() == 3);
+}
+#endif
@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <catch2/catch.hpp>
+
+#include <gsl/optional_ref.hpp>
+#include <gsl/retained_vector.hpp>
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using gsl::make_retained;
+using gsl::retained;
+using gsl::retained_vector;
+using gsl::sorted_retained_vector;
+
+namespace
+{
+  template <typename Vector, typename It, typename = void>
+  struct can_insert_range : std::false_type
+  {
+  };
+
+  template <typename Vector, typename It>
+  struct can_insert_range<
+      Vector,
+      It,
+      std::void_t<decltype(std::declval<Vector&>().insert(
+          std::declval<It>(), std::declval<It>()))>>
+  : std::true_type
+  {
+  };
+
+  template <typename Vector, typename Key, typename = void>
+  struct can_look_up : std::false_type
+  {
+  };
+
+  template <typename Vector, typename Key>
+  struct can_look_up<
+      Vector,
+      Key,
+      std::void_t<
+          decltype(std::declval<Vector&>().find(std::declval<Key>())),
+          decltype(std::declval<Vector&>().contains(std::declval<Key>())),
+          decltype(std::declval<Vector&>().erase(std::declval<Key>()))>>
+  : std::true_type
+  {
+  };
+
+    int sum(int const* const* values, std::size_t size)
+  {
+    int total = 0;
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      total += *values[i];
+    }
+
+    return total;
+  }
+
+} // namespace
+
+SCENARIO("`retained_vector`s cannot be copied")
+{
+  CHECK_FALSE(std::is_copy_constructible_v<retained_vector<int>>);
+  CHECK_FALSE(std::is_copy_assignable_v<retained_vector<int>>);
+  CHECK(std::is_nothrow_move_constructible_v<retained_vector<int>>);
+}
+
+SCENARIO("`retained_vector`s give access to the objects they reference")
+{
+  std::array<int, 3> i = {1, 2, 3};
+
+  GIVEN("a `retained_vector` with elements appended")
+  {
+    retained_vector<int> v;
+
+    v.push_back(make_retained(i[0]));
+    v.push_back(make_retained(i[1]));
+    v.insert(make_retained(i[2]));
+
+    CHECK(v.size() == 3);
+    CHECK(!v.empty());
+    CHECK(&v[0] == &i[0]);
+    CHECK(&v.at(1) == &i[1]);
+    CHECK(&v.front() == &i[0]);
+    CHECK(&v.back() == &i[2]);
+    CHECK_THROWS_AS(v.at(3), std::out_of_range);
+    CHECK(std::accumulate(v.begin(), v.end(), 0) == 6);
+
+    WHEN("the referenced objects are modified through it")
+    {
+      for (auto& e : v)
+      {
+        e *= 10;
+      }
+
+      CHECK(i[0] == 10);
+      CHECK(i[1] == 20);
+      CHECK(i[2] == 30);
+    }
+
+    THEN("const access is read-only")
+    {
+      retained_vector<int> const& c = v;
+
+      CHECK(std::is_same_v<decltype(c[0]), int const&>);
+      CHECK(std::is_same_v<decltype(*c.begin()), int const&>);
+      CHECK(std::is_same_v<decltype(c.data()), int const* const*>);
+      CHECK(std::is_same_v<decltype(v.data()), int* const*>);
+    }
+
+    THEN("the underlying pointers can be passed to C APIs")
+    {
+      CHECK(sum(std::as_const(v).data(), v.size()) == 6);
+    }
+  }
+}
+
+SCENARIO("`retained_vector`s support bulk insertion")
+{
+  std::array<int, 4> i = {1, 2, 3, 4};
+
+  std::vector<retained<int>> rs;
+
+  for (auto& e : i)
+  {
+    rs.push_back(make_retained(e));
+  }
+
+  retained_vector<int> v;
+  v.push_back(make_retained(i[3]));
+  v.insert(rs.begin(), rs.begin() + 3);
+
+  REQUIRE(v.size() == 4);
+  REQUIRE(&v[0] == &i[3]);
+  REQUIRE(&v[1] == &i[0]);
+  REQUIRE(&v[3] == &i[2]);
+
+  // Ranges that may hold null cannot be inserted.
+  CHECK(can_insert_range<retained_vector<int const>, retained<int>*>::value);
+  CHECK(!can_insert_range<retained_vector<int>, retained<int const>*>::value);
+  CHECK(!can_insert_range<retained_vector<int>, int**>::value);
+  CHECK(!can_insert_range<retained_vector<int>, gsl::optional_ref<int>*>::value);
+
+  // Nor can ranges that only give const access to the referenced objects.
+  using const_iterator = std::vector<retained<int>>::const_iterator;
+  CHECK(!can_insert_range<retained_vector<int>, const_iterator>::value);
+  CHECK(can_insert_range<retained_vector<int const>, const_iterator>::value);
+
+  GIVEN("an element inserted at a position")
+  {
+    int j = {};
+
+    v.insert(v.begin() + 1, make_retained(j));
+
+    REQUIRE(&v[1] == &j);
+    REQUIRE(v.size() == 5);
+  }
+}
+
+SCENARIO("`retained_vector`s support removal by address")
+{
+  std::array<int, 4> i = {1, 2, 3, 4};
+  int j = {};
+
+  retained_vector<int> v;
+
+  for (auto& e : i)
+  {
+    v.push_back(make_retained(e));
+  }
+
+  CHECK(v.contains(i[2]));
+  CHECK(!v.contains(j));
+  CHECK(&*v.find(i[2]) == &i[2]);
+  CHECK(v.find(j) == v.end());
+
+  // Temporaries are never referenced, so they cannot be looked up.
+  CHECK(can_look_up<retained_vector<int>, int&>::value);
+  CHECK(!can_look_up<retained_vector<int>, int>::value);
+  CHECK(!can_look_up<retained_vector<int>, int const&&>::value);
+
+  GIVEN("an element erased by address")
+  {
+    REQUIRE(v.erase(i[1]));
+    REQUIRE(!v.erase(j));
+
+    REQUIRE(v.size() == 3);
+    REQUIRE(&v[0] == &i[0]);
+    REQUIRE(&v[1] == &i[2]);
+    REQUIRE(&v[2] == &i[3]);
+  }
+
+  GIVEN("an element removed by swap-and-pop")
+  {
+    REQUIRE(v.swap_remove(i[0]));
+    REQUIRE(!v.swap_remove(j));
+
+    REQUIRE(v.size() == 3);
+    REQUIRE(&v[0] == &i[3]);
+    REQUIRE(&v[1] == &i[1]);
+    REQUIRE(&v[2] == &i[2]);
+  }
+
+  GIVEN("elements erased by iterator")
+  {
+    auto it = v.erase(v.begin());
+
+    REQUIRE(&*it == &i[1]);
+
+    v.erase(v.begin(), v.begin() + 2);
+
+    REQUIRE(v.size() == 1);
+    REQUIRE(&v[0] == &i[3]);
+  }
+}
+
+SCENARIO("`sorted_retained_vector`s are ordered by address")
+{
+  std::array<int, 5> i = {};
+
+  sorted_retained_vector<int> v;
+
+  v.insert(make_retained(i[3]));
+  v.insert(make_retained(i[0]));
+  v.insert(make_retained(i[4]));
+
+  std::vector<retained<int>> rs;
+  rs.push_back(make_retained(i[2]));
+  rs.push_back(make_retained(i[1]));
+
+  v.insert(rs.begin(), rs.end());
+
+  REQUIRE(v.size() == 5);
+
+  for (std::size_t n = 0; n < i.size(); ++n)
+  {
+    REQUIRE(&v[n] == &i[n]);
+  }
+
+  GIVEN("elements found and erased by binary search")
+  {
+    REQUIRE(&*v.find(i[3]) == &i[3]);
+    REQUIRE(v.erase(i[3]));
+    REQUIRE(!v.contains(i[3]));
+    REQUIRE(v.size() == 4);
+    REQUIRE(std::is_sorted(v.data(), v.data() + v.size()));
+  }
+}
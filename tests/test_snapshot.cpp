@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <catch2/catch.hpp>
+
+#include <gsl/snapshot.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+using gsl::make_retained;
+using gsl::optional_retained;
+using gsl::retained;
+
+namespace
+{
+  struct node
+  {
+    // A root node is its own parent.
+    explicit node(int value)
+    : value(value)
+    , parent(*this)
+    {
+    }
+
+    node(int value, node const& parent)
+    : value(value)
+    , parent(parent)
+    {
+    }
+
+    int value;
+    retained<node const> parent;
+    optional_retained<node> next;
+  };
+
+  using format = gsl::snapshot_format<node, &node::parent, &node::next>;
+
+  // Suitably aligned storage standing in for a memory-mapped file.
+  class storage
+  {
+  public:
+    explicit storage(std::size_t size)
+    : m_words(new std::max_align_t[size / sizeof(std::max_align_t) + 1])
+    {
+    }
+
+    void* data() const noexcept
+    {
+      return m_words.get();
+    }
+
+  private:
+    std::unique_ptr<std::max_align_t[]> m_words;
+  };
+
+  std::vector<node> make_nodes()
+  {
+    std::vector<node> nodes;
+    nodes.reserve(3);
+
+    nodes.emplace_back(0);
+    nodes.emplace_back(1, nodes[0]);
+    nodes.emplace_back(2, nodes[0]);
+
+    nodes[0].next = make_retained(nodes[1]);
+    nodes[1].next = make_retained(nodes[2]);
+
+    return nodes;
+  }
+
+} // namespace
+
+SCENARIO("arrays wired with `retained` references can be snapshotted")
+{
+  CHECK(format::alignment >= alignof(node));
+
+  GIVEN("a snapshot of an array of nodes")
+  {
+    std::vector<node> nodes = make_nodes();
+    std::vector<unsigned char> bytes = format::write(nodes.data(), nodes.size());
+
+    CHECK(bytes.size() == format::size(nodes.size()));
+
+    WHEN("it is copied to new storage and loaded")
+    {
+      storage s(bytes.size());
+      std::memcpy(s.data(), bytes.data(), bytes.size());
+
+      auto [loaded, count] = format::load(s.data(), bytes.size());
+
+      THEN("the loaded nodes reference each other")
+      {
+        REQUIRE(count == 3);
+        REQUIRE(loaded[0].value == 0);
+        REQUIRE(&*loaded[0].parent == &loaded[0]);
+        REQUIRE(&*loaded[1].parent == &loaded[0]);
+        REQUIRE(&*loaded[2].parent == &loaded[0]);
+        REQUIRE(&*loaded[0].next == &loaded[1]);
+        REQUIRE(&*loaded[1].next == &loaded[2]);
+        REQUIRE(!loaded[2].next);
+        REQUIRE(loaded[0].next->next->value == 2);
+      }
+    }
+
+    WHEN("it is truncated")
+    {
+      storage s(bytes.size());
+      std::memcpy(s.data(), bytes.data(), bytes.size());
+
+      CHECK_THROWS_AS(format::load(s.data(), bytes.size() - 1), std::invalid_argument);
+    }
+
+    WHEN("it is loaded in a different format")
+    {
+      storage s(bytes.size());
+      std::memcpy(s.data(), bytes.data(), bytes.size());
+
+      using other = gsl::snapshot_format<node, &node::parent>;
+
+      CHECK_THROWS_AS(other::load(s.data(), bytes.size()), std::invalid_argument);
+    }
+  }
+
+  GIVEN("an array of nodes that references a node outside of it")
+  {
+    node outside(42);
+    std::vector<node> nodes = make_nodes();
+    nodes[2].next = make_retained(outside);
+
+    CHECK_THROWS_AS(format::write(nodes.data(), nodes.size()), std::invalid_argument);
+  }
+}
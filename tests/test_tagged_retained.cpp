@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2016 - 2019 Joseph Thomson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <catch2/catch.hpp>
+
+#include <gsl/tagged_retained.hpp>
+
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using gsl::make_retained;
+using gsl::make_tagged_retained;
+using gsl::tagged_retained;
+
+namespace
+{
+  struct alignas(8) node
+  {
+    int value = {};
+  };
+} // namespace
+
+SCENARIO("`tagged_retained` occupies no more memory than `T*`")
+{
+  CHECK(sizeof(tagged_retained<node, 3>) == sizeof(node*));
+  CHECK(std::is_trivially_move_constructible_v<tagged_retained<node, 3>>);
+  CHECK(!std::is_copy_constructible_v<tagged_retained<node, 3>>);
+  CHECK(!std::is_constructible_v<tagged_retained<node, 3>, node&&>);
+  CHECK(gsl::is_trivially_relocatable_v<tagged_retained<node, 3>>);
+  CHECK(tagged_retained<node, 3>::max_tag == 7);
+}
+
+SCENARIO("`tagged_retained` stores a tag alongside the reference")
+{
+  GIVEN("a `tagged_retained` with a tag")
+  {
+    node n = {1};
+    auto t = make_tagged_retained<3>(n, 5);
+    auto const& ct = t;
+
+    THEN("the object and tag can be accessed")
+    {
+      CHECK(t.get() == &n);
+      CHECK(std::is_same_v<decltype(ct.get()), node const*>);
+      CHECK(ct->value == 1);
+      CHECK(&*t == &n);
+      CHECK(t.tag() == 5);
+    }
+
+    WHEN("the tag is changed")
+    {
+      t.set_tag(2);
+
+      THEN("the reference is unchanged")
+      {
+        CHECK(t.get() == &n);
+        CHECK(t.tag() == 2);
+      }
+    }
+
+    WHEN("the tag is changed atomically")
+    {
+      auto const before_or = t.fetch_or_tag(2);
+      auto const after_or = t.load_tag();
+      auto const before_and = t.fetch_and_tag(3);
+
+      THEN("the previous tags are returned")
+      {
+        CHECK(before_or == 5);
+        CHECK(after_or == 7);
+        CHECK(before_and == 7);
+        CHECK(t.tag() == 3);
+        CHECK(t.get() == &n);
+      }
+    }
+
+    WHEN("it is moved and converted")
+    {
+      tagged_retained<node const, 3> c = std::move(t);
+
+      THEN("the reference and tag are preserved")
+      {
+        CHECK(c.get() == &n);
+        CHECK(c.tag() == 5);
+        CHECK(c == tagged_retained<node, 3>(make_retained(n)));
+      }
+    }
+  }
+}
+
+SCENARIO("`tagged_retained` tags can be set concurrently")
+{
+  GIVEN("a set of `tagged_retained`s")
+  {
+    std::vector<node> nodes(1000);
+    std::vector<tagged_retained<node, 2>> edges;
+
+    for (auto& n : nodes)
+    {
+      edges.emplace_back(n);
+    }
+
+    WHEN("two threads mark different bits of every tag")
+    {
+      auto mark = [&](std::uintptr_t bit) {
+        for (auto& e : edges)
+        {
+          e.fetch_or_tag(bit, std::memory_order_relaxed);
+        }
+      };
+
+      std::thread a(mark, 1);
+      std::thread b(mark, 2);
+      a.join();
+      b.join();
+
+      THEN("no mark is lost")
+      {
+        for (std::size_t i = 0; i < edges.size(); ++i)
+        {
+          REQUIRE(edges[i].tag() == 3);
+          REQUIRE(edges[i].get() == &nodes[i]);
+        }
+      }
+    }
+  }
+}